@@ -505,8 +505,7 @@ namespace effolkronium {
     protected:
         /// get reference to the static engine instance
         static Engine& engine_instance( ) {
-            Seeder seeder{ };
-            static Engine engine{ seeder( ) };
+            static Engine engine{ Seeder{ }( ) };
             return engine;
         }
     };
@@ -881,8 +880,7 @@ namespace effolkronium {
     protected:
         /// get reference to the thread local engine instance
         static Engine& engine_instance( ) {
-	    Seeder seeder{ };
-            thread_local Engine engine{ seeder( ) };
+            thread_local Engine engine{ Seeder{ }( ) };
             return engine;
         }
     };
@@ -0,0 +1,29 @@
+#ifndef RLRPG_ALIAS_TABLE_HPP
+#define RLRPG_ALIAS_TABLE_HPP
+
+#include<level_random.hpp>
+
+#include<vector>
+
+//////////////////////////////////////////////////
+// Weighted random choice of an index in O(1), built in O(n) with Vose's alias method.
+// Every column i is split between i itself (with `probability[i]`) and `alias[i]`.
+class AliasTable {
+public:
+    AliasTable() = default;
+
+    // weights must be non-negative, zero weights are never picked
+    explicit AliasTable(std::vector<double> const & weights);
+
+    // returns -1 if the table is empty or all weights are zero
+    int pick(LevelRandom & random) const;
+
+    int size() const { return static_cast<int>(probability.size()); }
+    bool empty() const { return probability.empty(); }
+
+private:
+    std::vector<double> probability;
+    std::vector<int> alias;
+};
+
+#endif // RLRPG_ALIAS_TABLE_HPP
@@ -25,5 +25,7 @@
 #define CONTROL_READ 'r'
 #define CONTROL_OPENBANDOLIER 'a'
 #define CONTROL_RELOAD 'R'
+#define CONTROL_DESCEND '>'
+#define CONTROL_ASCEND '<'
 
 #endif // CONTROLS_HPP
@@ -0,0 +1,67 @@
+#ifndef RLRPG_DUNGEON_LEVEL_HPP
+#define RLRPG_DUNGEON_LEVEL_HPP
+
+#include<level.hpp>
+#include<item_piles.hpp>
+#include<render_data.hpp>
+#include<free_cells.hpp>
+#include<type_id.hpp>
+#include<ptr.hpp>
+
+#include<termlib/vec2.hpp>
+
+class Unit;
+class Item;
+
+//////////////////////////////////////////////////
+// Everything one floor of the dungeon consists of, and what the hero remembers of it. The game
+// plays on one of these at a time, the next one is built by LevelFactory while the hero is
+// still on the current floor.
+struct DungeonLevel {
+    // `tileTypes` has to outlive the level
+    explicit DungeonLevel(TileTypes const & tileTypes);
+    ~DungeonLevel();
+
+    DungeonLevel(DungeonLevel const &) = delete;
+    DungeonLevel & operator=(DungeonLevel const &) = delete;
+
+    // the hero comes down the stairs here, no other unit is placed on this cell when the level is built
+    bool isEntrance(Coord2i cell) const { return cell == entrance; }
+    bool isStairsUp(Coord2i cell) const { return depth > 1 and cell == entrance; }
+    bool isStairsDown(Coord2i cell) const { return cell == stairsDown; }
+
+    // the closest walkable cell to `cell` without a unit, `cell` itself if it is free
+    Coord2i findFreeCellNear(Coord2i cell) const;
+
+    // Tiles and units that are already on the level are changed only through these,
+    // so freeCells stays in sync with them
+    void setTile(Coord2i cell, Tile tile);
+    void placeUnit(Ptr<Unit> unit, Coord2i cell);
+    Ptr<Unit> removeUnit(Coord2i cell);
+    void moveUnit(Coord2i from, Coord2i to);
+
+    // fills freeCells from scratch once the tiles were written directly
+    void indexFreeCells();
+
+    // stackable items join an item of the same type in the cell. Items lie wherever they
+    // can fly to, on any tile that isn't opaque
+    void drop(Ptr<Item> item, Coord2i cell);
+
+    // nullptr if there is no item of this type in the cell
+    Item * findItemAt(Coord2i cell, TypeID typeID);
+
+    TileTypes const & tileTypes;
+    LevelData tiles;
+    ItemPiles items;
+    Array2D<Ptr<Unit>, LEVEL_ROWS, LEVEL_COLS> units;
+    FreeCells freeCells;
+
+    // what the hero last saw in the cells out of view, packed with the floor when the hero leaves
+    Array2D<PackedCell, LEVEL_ROWS, LEVEL_COLS> remembered;
+
+    int depth = 1;
+    Coord2i entrance{ -1, -1 };
+    Coord2i stairsDown{ -1, -1 };
+};
+
+#endif // RLRPG_DUNGEON_LEVEL_HPP
@@ -0,0 +1,36 @@
+#ifndef RLRPG_FLOOR_ARCHIVE_HPP
+#define RLRPG_FLOOR_ARCHIVE_HPP
+
+#include<dungeon_level.hpp>
+#include<ptr.hpp>
+
+#include<cstdint>
+#include<vector>
+
+class GameData;
+
+//////////////////////////////////////////////////
+// A dungeon level packed into bytes while the hero is on another floor. Tiles and the
+// remembered map are stored as runs, items and units as their type plus the few fields that
+// differ from the prototype, with variable-length integers throughout, so a floor takes
+// a few kilobytes.
+class PackedFloor {
+public:
+    int getDepth() const { return depth; }
+    std::size_t getSize() const { return bytes.size(); }
+
+    friend PackedFloor packFloor(DungeonLevel const & level);
+    friend Ptr<DungeonLevel> unpackFloor(PackedFloor const & packed, GameData const & data);
+
+private:
+    int depth = 0;
+    std::vector<std::uint8_t> bytes;
+};
+
+// Only enemies can be packed, the hero must be taken off the level first
+PackedFloor packFloor(DungeonLevel const & level);
+
+// Recreates items and units from the prototypes of `data`
+Ptr<DungeonLevel> unpackFloor(PackedFloor const & packed, GameData const & data);
+
+#endif // RLRPG_FLOOR_ARCHIVE_HPP
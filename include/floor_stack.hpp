@@ -0,0 +1,50 @@
+#ifndef RLRPG_FLOOR_STACK_HPP
+#define RLRPG_FLOOR_STACK_HPP
+
+#include<floor_archive.hpp>
+
+#include<tl/optional.hpp>
+
+#include<cstddef>
+#include<cstdint>
+#include<list>
+#include<unordered_map>
+#include<vector>
+
+//////////////////////////////////////////////////
+// Floors of the dungeon the hero isn't on. Visited floors are kept packed, least recently
+// left first to go once they take more than the memory budget. Every depth gets its seed
+// when it is first asked for, so a floor that was dropped is generated again the same
+// (without what happened on it since).
+class FloorStack {
+public:
+    static std::size_t const DEFAULT_MEMORY_BUDGET = 1024 * 1024;
+
+    explicit FloorStack(std::size_t memoryBudget = DEFAULT_MEMORY_BUDGET): memoryBudget(memoryBudget) {}
+
+    // seed to generate the floor at `depth` with
+    std::uint64_t getSeed(int depth);
+
+    bool contains(int depth) const { return floors.count(depth); }
+
+    // packs the floor the hero leaves, drops the least recently left ones if over the budget
+    void store(DungeonLevel const & level);
+
+    // takes the floor out of the stack, so only the current floor is ever unpacked
+    tl::optional<PackedFloor> take(int depth);
+
+    // bytes taken by the packed floors
+    std::size_t getMemoryUsage() const { return memoryUsage; }
+    int size() const { return static_cast<int>(floors.size()); }
+
+private:
+    std::size_t memoryBudget;
+    std::size_t memoryUsage = 0;
+
+    std::vector<std::uint64_t> seeds; // by depth - 1
+
+    std::list<PackedFloor> recentlyLeft; // most recent first
+    std::unordered_map<int, std::list<PackedFloor>::iterator> floors; // by depth
+};
+
+#endif // RLRPG_FLOOR_STACK_HPP
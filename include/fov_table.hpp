@@ -0,0 +1,138 @@
+#ifndef RLRPG_FOV_TABLE_HPP
+#define RLRPG_FOV_TABLE_HPP
+
+#include<line_of_sight.hpp>
+#include<level.hpp>
+
+#include<termlib/vec2.hpp>
+
+#include<cstdint>
+#include<algorithm>
+
+// Rays of the visibility check only depend on the offset between the cells, so for all
+// offsets closer than RLRPG_FOV_TABLE_RADIUS they are traced once, at compile time.
+// Visibility over longer distances falls back to los::isVisible.
+#ifndef RLRPG_FOV_TABLE_RADIUS
+#define RLRPG_FOV_TABLE_RADIUS 16
+#endif
+
+namespace fov {
+    int const TABLE_RADIUS = RLRPG_FOV_TABLE_RADIUS;
+    int const TABLE_SIDE = 2 * TABLE_RADIUS + 1;
+    int const RAYS_PER_CELL = 4;
+
+    static_assert(TABLE_RADIUS > 0 and TABLE_RADIUS < 128, "Table offsets are stored in int8_t");
+
+    struct RayCell {
+        std::int8_t x, y;
+    };
+
+    struct TableEntry {
+        std::int8_t x, y;
+        std::uint16_t rays[RAYS_PER_CELL + 1]; // ray i covers RayTable::cells [rays[i], rays[i + 1])
+    };
+
+    namespace detail {
+        constexpr bool inTable(int x, int y) {
+            return x * x + y * y < TABLE_RADIUS * TABLE_RADIUS;
+        }
+
+        // same rays as los::isVisible casts, with the origin cell at (0, 0)
+        template<class Fn>
+        constexpr void forEachRay(int x, int y, Fn && onRay) {
+            long long const nearEdge = los::SCALE / los::PRECISION;
+            long long const farEdge = los::SCALE - nearEdge;
+            long long const corners[RAYS_PER_CELL][2] = {
+                { nearEdge, nearEdge },
+                { nearEdge, farEdge },
+                { farEdge, nearEdge },
+                { farEdge, farEdge }
+            };
+            for (auto const & corner : corners) {
+                onRay(los::SCALE / 2, los::SCALE / 2, x * los::SCALE + corner[0], y * los::SCALE + corner[1]);
+            }
+        }
+
+        constexpr int countEntries() {
+            int count = 0;
+            for (int y = -TABLE_RADIUS; y <= TABLE_RADIUS; ++y)
+                for (int x = -TABLE_RADIUS; x <= TABLE_RADIUS; ++x)
+                    if (inTable(x, y))
+                        ++count;
+            return count;
+        }
+
+        constexpr int countCells() {
+            int count = 0;
+            for (int y = -TABLE_RADIUS; y <= TABLE_RADIUS; ++y) {
+                for (int x = -TABLE_RADIUS; x <= TABLE_RADIUS; ++x) {
+                    if (not inTable(x, y))
+                        continue;
+                    forEachRay(x, y, [&count] (long long fromX, long long fromY, long long toX, long long toY) {
+                        los::walkRay(fromX, fromY, toX, toY, [&count] (long long, long long) {
+                            ++count;
+                            return true;
+                        });
+                    });
+                }
+            }
+            return count;
+        }
+    }
+
+    int const ENTRY_COUNT = detail::countEntries();
+    int const CELL_COUNT = detail::countCells();
+
+    static_assert(CELL_COUNT <= UINT16_MAX, "Ray cells are indexed with uint16_t");
+
+    struct RayTable {
+        TableEntry entries[ENTRY_COUNT];            // sorted by distance from the origin
+        RayCell cells[CELL_COUNT];
+        std::int16_t index[TABLE_SIDE][TABLE_SIDE]; // entry of the offset (x, y) is at [y + R][x + R], -1 if none
+        std::uint16_t entriesWithin[TABLE_RADIUS + 1]; // entries [0, entriesWithin[r]) are closer than r
+    };
+
+    extern RayTable const rayTable;
+
+    inline TableEntry const * findEntry(Vec2i offset) {
+        if (offset.x < -TABLE_RADIUS or offset.x > TABLE_RADIUS or offset.y < -TABLE_RADIUS or offset.y > TABLE_RADIUS)
+            return nullptr;
+        int entry = rayTable.index[offset.y + TABLE_RADIUS][offset.x + TABLE_RADIUS];
+        return entry < 0 ? nullptr : &rayTable.entries[entry];
+    }
+
+    // Walks the precomputed rays of `entry` starting at `from`, stops at the first opaque cell of each ray
+    bool isVisible(LevelData const & level, TileTypes const & tileTypes, Coord2i from, TableEntry const & entry);
+
+    // Same result as los::isVisible, but uses the ray table when `to` is close enough to `from`
+    bool isVisible(LevelData const & level, TileTypes const & tileTypes, Coord2i from, Coord2i to);
+
+    // Calls `onCell(cell)` for every level cell closer than `radius` to `from` and visible from it
+    template<class Fn>
+    void forEachVisibleCell(LevelData const & level, TileTypes const & tileTypes, Coord2i from, int radius, Fn && onCell) {
+        if (radius <= 0)
+            return;
+
+        if (radius <= TABLE_RADIUS) {
+            for (int i = 0; i < rayTable.entriesWithin[radius]; ++i) {
+                auto const & entry = rayTable.entries[i];
+                Coord2i cell = from + Vec2i{ entry.x, entry.y };
+                if (level.isIndex(cell) and isVisible(level, tileTypes, from, entry))
+                    onCell(cell);
+            }
+            return;
+        }
+
+        Coord2i first{ std::max(from.x - radius, 0), std::max(from.y - radius, 0) };
+        Coord2i last{ std::min(from.x + radius, LEVEL_COLS - 1), std::min(from.y + radius, LEVEL_ROWS - 1) };
+        for (Coord2i cell = first; cell.y <= last.y; ++cell.y) {
+            for (cell.x = first.x; cell.x <= last.x; ++cell.x) {
+                Vec2i d = cell - from;
+                if (d * d < radius * radius and los::isVisible(level, tileTypes, from, cell))
+                    onCell(cell);
+            }
+        }
+    }
+} // namespace fov
+
+#endif // RLRPG_FOV_TABLE_HPP
@@ -0,0 +1,47 @@
+#ifndef RLRPG_FREE_CELLS_HPP
+#define RLRPG_FREE_CELLS_HPP
+
+#include<level.hpp>
+
+#include<termlib/vec2.hpp>
+
+#include<array>
+#include<cstdint>
+#include<vector>
+
+//////////////////////////////////////////////////
+// Walkable cells of a level nothing stands on. The cells are kept in a vector and every cell
+// remembers its place in it, so adding, removing (by swapping with the last one) and picking
+// the n-th cell for a random placement are all O(1).
+class FreeCells {
+public:
+    FreeCells();
+
+    bool contains(Coord2i cell) const { return places[toIndex(cell)] != NONE; }
+
+    int size() const { return static_cast<int>(cells.size()); }
+    bool isEmpty() const { return cells.empty(); }
+
+    // in no particular order, changes as cells are added and removed
+    Coord2i operator [](int place) const { return toCell(cells[place]); }
+
+    // both do nothing if the cell is already in / not in the set
+    void add(Coord2i cell);
+    void remove(Coord2i cell);
+
+    void clear();
+    void reserve(int cellCount) { cells.reserve(cellCount); }
+
+private:
+    static_assert(LEVEL_ROWS * LEVEL_COLS <= INT16_MAX, "Cell indices must fit std::int16_t");
+
+    static constexpr std::int16_t NONE = -1;
+
+    static int toIndex(Coord2i cell) { return cell.y * LEVEL_COLS + cell.x; }
+    static Coord2i toCell(int index) { return Coord2i{ index % LEVEL_COLS, index / LEVEL_COLS }; }
+
+    std::vector<std::int16_t> cells; // cell indices
+    std::array<std::int16_t, LEVEL_ROWS * LEVEL_COLS> places; // by cell index, NONE if not free
+};
+
+#endif // RLRPG_FREE_CELLS_HPP
@@ -5,10 +5,15 @@
 #include<render_data.hpp>
 #include<level.hpp>
 #include<registry.hpp>
-#include<meta/check.hpp>
 #include<ptr.hpp>
-
-#include<effolkronium/random.hpp>
+#include<type_id.hpp>
+#include<items/item.hpp>
+#include<items/potion.hpp>
+#include<item_piles.hpp>
+#include<dungeon_level.hpp>
+#include<game_data.hpp>
+#include<level_factory.hpp>
+#include<floor_stack.hpp>
 
 #include<termlib/termlib.hpp>
 
@@ -17,47 +22,51 @@
 #include<string>
 #include<string_view>
 #include<vector>
-#include<unordered_map>
-#include<list>
-#include<memory>
-#include<type_traits>
 
 class Unit;
 class Hero;
 class Enemy;
 
-class Item;
-class Food;
-class Armor;
-class Weapon;
-class Ammo;
-class Scroll;
-class Potion;
+// Asymmetric: every unit traces its own rays to decide if it sees a cell.
+// Symmetric: a ray from the hero to a cell also counts as the cell seeing the hero,
+// so enemies reuse the hero's field of view instead of tracing rays themselves.
+enum class VisionModel {
+    Asymmetric,
+    Symmetric
+};
 
-class YAMLFileCache;
+//////////////////////////////////////////////////
+// One game session: the hero, the floors and the settings of one player, drawn on and fed
+// keys from its own terminal window. The data read from data/ is shared with the other
+// sessions and never changed; nothing of a session is global, so a process can host many
+// of them, each on whatever thread it is stepped on.
+class Game {
+public:
+    // `data` has to be loaded and to outlive the game
+    Game(GameData const & data, AbstractTerminalWindow & window);
+    ~Game();
 
-namespace YAML {
-    class Node;
-}
+    Game(Game const &) = delete;
+    Game & operator=(Game const &) = delete;
 
-using ItemPile = std::list<Ptr<Item>>;
+    // the menus, then the game until the hero dies or the player quits
+    void run();
 
-namespace detail {
-    template<class T, meta::Check<IsClonable<T>> = meta::Checked>
-    Ptr<T> cloneAny(Registry<Ptr<T>> const & reg) {
-        return effolkronium::random_static::get(reg)->second->clone();
-    }
+    // Starts the game with the current settings, without the menus. The keys are then
+    // given to handleKey() one at a time, for hosts that read the keys themselves
+    void start();
 
-    template<class Fn, class ItemType>
-    constexpr bool IsItemSelector = std::is_invocable_r_v<Ptr<ItemType>, Fn, Registry<Ptr<ItemType>> const &>;
-}
+    // Plays the turn of `key`, returns false once the game is over. Prompts of the turn
+    // (what to drop, in what direction...) still read their keys from the window
+    bool handleKey(char key);
 
-class Game {
-public:
-    void run();
+    GameData const & getData() const { return data; }
+
+    LevelData const & level() const { return currLevel->tiles; }
 
-    LevelData const & level() const { return levelData; }
-    LevelData       & level()       { return levelData; }
+    // tiles and units are changed through the level, it keeps track of the free cells
+    DungeonLevel const & getCurrentLevel() const { return *currLevel; }
+    DungeonLevel       & getCurrentLevel()       { return *currLevel; }
 
     Hero const & getHero() const { return *hero; }
     Hero       & getHero()       { return *hero; }
@@ -70,6 +79,23 @@ public:
 
     bool needGenerateMap() const { return generateMap; }
 
+    // chosen in the settings, don't change once the game is started
+    LevelGenerator getLevelGenerator() const { return levelFactory.getGenerator(); }
+    void setLevelGenerator(LevelGenerator generator) { levelFactory.setGenerator(generator); }
+
+    void setMode(int newMode) { mode = newMode; }
+    void setVisionModel(VisionModel model) { visionModel = model; }
+
+    // Thrown items and bullets fly cell by cell with a pause between the frames. Hosts
+    // without a player watching turn that off, a pause would hold up their thread
+    void setAnimated(bool animate) { animated = animate; }
+    void pauseAnimation(double seconds) const;
+
+    // Levels are built by a worker thread of the game by default, so the next floor is ready
+    // when the hero gets there. Hosts that run many games on a pool of their own build them
+    // on the thread that steps the game instead. Set before start()
+    void setBuildLevelsInBackground(bool background) { levelFactory.setBackground(background); }
+
     bool skippingUpdate() const { return stop; }
     void skipUpdate(bool skip = false) { stop = skip; }
 
@@ -78,39 +104,31 @@ public:
 
     int getMode() const { return mode; }
 
-    void setHeroTemplate(Ptr<Hero> newHeroTemplate);
+    // 1 is the first level, picks entries of the spawn tables
+    int getDepth() const { return currLevel->depth; }
 
-    auto const & getItemsMap() const { return itemsMap; }
-    auto       & getItemsMap()       { return itemsMap; }
+    // Moves the hero by the stairs to the floor at `depth`. A floor visited before is unpacked,
+    // otherwise it is the level that was being built since the hero entered this one
+    void changeFloor(int depth);
 
-    auto const & getUnitsMap() const { return unitsMap; }
-    auto       & getUnitsMap()       { return unitsMap; }
+    VisionModel getVisionModel() const { return visionModel; }
 
-    Registry<Ptr<Food>> const & getFoodTypes() const { return foodTypes; }
-    Registry<Ptr<Food>>       & getFoodTypes()       { return foodTypes; }
+    // bumped every time level geometry changes, so cached visibility data can be invalidated
+    int getLevelRevision() const { return levelRevision; }
+    void markLevelChanged() { ++levelRevision; }
 
-    Registry<Ptr<Armor>> const & getArmorTypes() const { return armorTypes; }
-    Registry<Ptr<Armor>>       & getArmorTypes()       { return armorTypes; }
+    auto const & getItemsMap() const { return currLevel->items; }
+    auto       & getItemsMap()       { return currLevel->items; }
 
-    Registry<Ptr<Weapon>> const & getWeaponTypes() const { return weaponTypes; }
-    Registry<Ptr<Weapon>>       & getWeaponTypes()       { return weaponTypes; }
+    auto const & getUnitsMap() const { return currLevel->units; }
 
-    Registry<Ptr<Ammo>> const & getAmmoTypes() const { return ammoTypes; }
-    Registry<Ptr<Ammo>>       & getAmmoTypes()       { return ammoTypes; }
+    // Which potion does what is rolled for every game, and a potion shows its effect
+    // in its name once the player has learned it
+    Potion::Effect getPotionEffect(TypeID typeID) const { return potionEffects.at(typeID); }
+    bool isPotionKnown(TypeID typeID) const { return potionTypeKnown.at(typeID); }
+    void markPotionAsKnown(TypeID typeID) { potionTypeKnown.at(typeID) = true; }
 
-    Registry<Ptr<Scroll>> const & getScrollTypes() const { return scrollTypes; }
-    Registry<Ptr<Scroll>>       & getScrollTypes()       { return scrollTypes; }
-
-    Registry<Ptr<Potion>> const & getPotionTypes() const { return potionTypes; }
-    Registry<Ptr<Potion>>       & getPotionTypes()       { return potionTypes; }
-
-    Registry<Ptr<Enemy>> const & getEnemyTypes() const { return enemyTypes; }
-    Registry<Ptr<Enemy>>       & getEnemyTypes()       { return enemyTypes; }
-
-    Ptr<Item> createItem(std::string const & id);
-
-    bool isPotionKnown(std::string const & id) const { return potionTypeKnown.at(id); }
-    void markPotionAsKnown(std::string const & id) { potionTypeKnown.at(id) = true; }
+    std::string getItemName(Item const & item) const;
 
     void addMessage(std::string_view msg);
     void drop(Ptr<Item> item, Coord2i to);
@@ -120,87 +138,64 @@ private:
     tl::optional<std::string> processMenu(std::string_view title,
             std::vector<std::string_view> const & items, bool canExit = false);
     void mSettingsMode();
+    void mSettingsVision();
     void mSettingsMap();
     void mSettings();
     void mainMenu();
 
     std::vector<std::string> readTips() const;
 
-    void readItemRenderData(std::string const & id, YAMLFileCache & cache);
-    void readItemRenderData(YAMLFileCache & cache);
-    void readUnitRenderData(std::string const & id, YAML::Node const & renderData);
-    void readEnemyRenderData(std::string const & id, YAMLFileCache & cache);
-    void readHeroRenderData(YAMLFileCache & cache);
-    void readUnitRenderData(YAMLFileCache & cache);
-    SymbolRenderData getRenderData(Item const & item);
-    SymbolRenderData getRenderData(Unit const & unit);
-    tl::optional<CellRenderData> getRenderData(Coord2i cell);
-    void clearCachedMap();
+    // the top item, the stairs or the tile, everything in the cell but the unit
+    PackedCell getGroundRenderData(Coord2i cell) const;
+    // the hero forgets the map of the current floor
+    void forgetMap();
     void drawMap();
     void clearBuffers();
     void displayMessages();
     void draw();
 
-    void updateAI();
+    // clears the buffers for the next key, or tells the player the hero is dead
+    void beginTurn();
 
-    void loadData();
+    void updateAI();
 
-    void setItems();
-    void spawnUnits();
     void setRandomPotionEffects();
 
     void initialize();
-    void initField();
-    void readMap();
 
-    ItemPile::iterator findItemAt(Coord2i cell, std::string_view id);
-    bool randomlySetOnMap(Ptr<Item> item);
+    // makes `level` the current one, puts the hero as close to `arrival` as possible
+    // and starts building the next floor if it wasn't visited yet
+    void enterLevel(Ptr<DungeonLevel> level, Ptr<Unit> heroUnit, Coord2i arrival);
 
-    template<class ItemType, class Fn = decltype(&detail::cloneAny<ItemType>), meta::Check<detail::IsItemSelector<Fn, ItemType>> = meta::Checked>
-    void randomlySelectAndSetOnMap(Registry<Ptr<ItemType>> const & types, int n, Fn const & selector = &detail::cloneAny<ItemType>) {
-        for (int i = 0; i < n; ++i) {
-            auto selected = selector(types);
-            randomlySetOnMap(std::move(selected));
-        }
-    }
+    GameData const & data;
 
     TerminalRenderer termRend;
     TerminalReader termRead;
 
-    Registry<SymbolRenderData> itemRenderData;
-    Registry<SymbolRenderData> unitRenderData;
-    Array2D<tl::optional<CellRenderData>, LEVEL_ROWS, LEVEL_COLS> cachedMap;
+    Ptr<DungeonLevel> currLevel;
+    FloorStack floors;
 
-    Array2D<int, LEVEL_ROWS, LEVEL_COLS> levelData;
-    Array2D<ItemPile, LEVEL_ROWS, LEVEL_COLS> itemsMap;
-    Array2D<Ptr<Unit>, LEVEL_ROWS, LEVEL_COLS> unitsMap;
-
-    Registry<Ptr<Food>> foodTypes;
-    Registry<Ptr<Armor>> armorTypes;
-    Registry<Ptr<Weapon>> weaponTypes;
-    Registry<Ptr<Ammo>> ammoTypes;
-    Registry<Ptr<Scroll>> scrollTypes;
-    Registry<Ptr<Potion>> potionTypes;
+    Registry<Potion::Effect> potionEffects;
     Registry<bool> potionTypeKnown;
 
-    Registry<Ptr<Enemy>> enemyTypes;
-
     std::string message;
     std::string bar;
     std::string weaponBar;
 
-    Hero * hero;
-
-    Ptr<Hero> heroTemplate;
+    Hero * hero = nullptr;
 
     int mode = 1;
+    VisionModel visionModel = VisionModel::Symmetric;
     int turns = 0;
+    int levelRevision = 0;
     bool exit = false;
+    bool dead = false;
     bool stop = false;
     bool generateMap = true;
-};
+    bool animated = true;
 
-extern Game g_game;
+    // last, so its worker thread is done before the rest of the game is destroyed
+    LevelFactory levelFactory{ data };
+};
 
 #endif //RLRPG_GAME_HPP
-
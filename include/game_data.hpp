@@ -0,0 +1,161 @@
+#ifndef RLRPG_GAME_DATA_HPP
+#define RLRPG_GAME_DATA_HPP
+
+#include<render_data.hpp>
+#include<registry.hpp>
+#include<ptr.hpp>
+#include<type_id.hpp>
+#include<items/item.hpp>
+#include<spawn_table.hpp>
+#include<tile_types.hpp>
+
+#include<string>
+#include<vector>
+#include<deque>
+#include<array>
+
+class Unit;
+class Hero;
+class Enemy;
+
+class Food;
+class Armor;
+class Weapon;
+class Ammo;
+class Scroll;
+class Potion;
+
+class YAMLFileCache;
+
+namespace YAML {
+    class Node;
+}
+
+//////////////////////////////////////////////////
+// Everything read from data/: item and unit prototypes, their ids, how they are drawn and
+// the spawn tables. Loaded once and only read after that, so every game in the process,
+// on whatever thread, shares one. What a game changes lives in the Game.
+class GameData {
+public:
+    GameData();
+    ~GameData();
+
+    GameData(GameData const &) = delete;
+    GameData & operator=(GameData const &) = delete;
+
+    // Reads data/, throws if something is missing or broken
+    void load();
+
+    TypeIDTable const & getItemTypeIDs() const { return itemTypeIDs; }
+    TypeIDTable       & getItemTypeIDs()       { return itemTypeIDs; }
+
+    TypeIDTable const & getUnitTypeIDs() const { return unitTypeIDs; }
+    TypeIDTable       & getUnitTypeIDs()       { return unitTypeIDs; }
+
+    // shared data of item types, every item points to one of these
+    ItemTypeInfo & addItemType(std::string const & id);
+    ItemTypeInfo const & getItemTypeInfo(TypeID typeID) const { return itemTypeInfos.at(typeID.value); }
+    void clearItemTypes();
+
+    // item types the game logic refers to directly, resolved once after loading
+    struct BuiltinItemTypes {
+        TypeID map;
+        TypeID steelBullets;
+        TypeID shotgunBullets;
+    };
+
+    BuiltinItemTypes const & getBuiltinItemTypes() const { return builtinItemTypes; }
+
+    // the loader interns item ids category by category, so TypeIDs of one category are [first, last)
+    struct ItemTypeRange {
+        int first = 0;
+        int last = 0;
+
+        int size() const { return last - first; }
+        bool contains(TypeID typeID) const { return typeID.value >= first and typeID.value < last; }
+    };
+
+    ItemTypeRange getItemTypeRange(Item::Type type) const { return itemTypeRanges[static_cast<int>(type)]; }
+
+    Registry<Ptr<Food>> const & getFoodTypes() const { return foodTypes; }
+    Registry<Ptr<Food>>       & getFoodTypes()       { return foodTypes; }
+
+    Registry<Ptr<Armor>> const & getArmorTypes() const { return armorTypes; }
+    Registry<Ptr<Armor>>       & getArmorTypes()       { return armorTypes; }
+
+    Registry<Ptr<Weapon>> const & getWeaponTypes() const { return weaponTypes; }
+    Registry<Ptr<Weapon>>       & getWeaponTypes()       { return weaponTypes; }
+
+    Registry<Ptr<Ammo>> const & getAmmoTypes() const { return ammoTypes; }
+    Registry<Ptr<Ammo>>       & getAmmoTypes()       { return ammoTypes; }
+
+    Registry<Ptr<Scroll>> const & getScrollTypes() const { return scrollTypes; }
+    Registry<Ptr<Scroll>>       & getScrollTypes()       { return scrollTypes; }
+
+    Registry<Ptr<Potion>> const & getPotionTypes() const { return potionTypes; }
+    Registry<Ptr<Potion>>       & getPotionTypes()       { return potionTypes; }
+
+    Registry<Ptr<Enemy>> const & getEnemyTypes() const { return enemyTypes; }
+    Registry<Ptr<Enemy>>       & getEnemyTypes()       { return enemyTypes; }
+
+    Hero const & getHeroTemplate() const { return *heroTemplate; }
+    void setHeroTemplate(Ptr<Hero> newHeroTemplate);
+
+    // what levels are made of, from data/tiles.yaml
+    TileTypes const & getTileTypes() const { return tileTypes; }
+
+    SpawnTable const & getItemSpawnTable() const { return itemSpawnTable; }
+    SpawnTable const & getEnemySpawnTable() const { return enemySpawnTable; }
+
+    Ptr<Item> createItem(TypeID typeID) const;
+    Ptr<Item> createItem(std::string const & id) const;
+
+    PackedCell getRenderData(Item const & item) const;
+    PackedCell getRenderData(Unit const & unit) const;
+
+    // the longest vision distance among all enemy types
+    int getMaxEnemyVision() const { return maxEnemyVision; }
+
+private:
+    void readItemRenderData(std::string const & id, YAMLFileCache & cache);
+    void readItemRenderData(YAMLFileCache & cache);
+    void readUnitRenderData(std::string const & id, YAML::Node const & renderData);
+    void readEnemyRenderData(std::string const & id, YAMLFileCache & cache);
+    void readHeroRenderData(YAMLFileCache & cache);
+    void readUnitRenderData(YAMLFileCache & cache);
+
+    void indexItemTypes();
+    void readSpawnTables(YAMLFileCache & cache);
+    void readTileTypes(YAMLFileCache & cache);
+
+    std::vector<PackedCell> itemRenderData; // by item TypeID, empty if there is none
+    std::vector<PackedCell> unitRenderData; // by unit TypeID, empty if there is none
+
+    TypeIDTable itemTypeIDs;
+    TypeIDTable unitTypeIDs;
+
+    std::deque<ItemTypeInfo> itemTypeInfos; // by item TypeID, deque keeps references valid
+    BuiltinItemTypes builtinItemTypes;
+
+    std::vector<Item const *> itemPrototypes; // by item TypeID, points into the registries below
+    std::array<ItemTypeRange, Item::TYPE_COUNT> itemTypeRanges;
+
+    SpawnTable itemSpawnTable;
+    SpawnTable enemySpawnTable;
+
+    TileTypes tileTypes;
+
+    Registry<Ptr<Food>> foodTypes;
+    Registry<Ptr<Armor>> armorTypes;
+    Registry<Ptr<Weapon>> weaponTypes;
+    Registry<Ptr<Ammo>> ammoTypes;
+    Registry<Ptr<Scroll>> scrollTypes;
+    Registry<Ptr<Potion>> potionTypes;
+
+    Registry<Ptr<Enemy>> enemyTypes;
+    Ptr<Hero> heroTemplate;
+
+    int maxEnemyVision = 0;
+};
+
+#endif // RLRPG_GAME_DATA_HPP
@@ -0,0 +1,80 @@
+#ifndef RLRPG_GEN_CAVES_HPP
+#define RLRPG_GEN_CAVES_HPP
+
+#include<array2d.hpp>
+#include<level_random.hpp>
+#include<tile_types.hpp>
+
+#include<cstdint>
+#include<vector>
+
+// Cave levels grown by a cellular automaton: the map starts as random noise and every step
+// turns a cell into wall or floor by how many of its eight neighbours are walls. Cells are
+// kept a bit each, so a step works on 64 cells at once, counting their neighbours with
+// bitwise adders instead of one cell at a time.
+namespace gen {
+    //////////////////////////////////////////////////
+    // A bit per cell, set for walls. Every row is padded to whole words, the padding
+    // and everything outside of the grid count as walls.
+    class BitGrid {
+    public:
+        BitGrid(int rows, int cols);
+
+        int getRows() const { return rows; }
+        int getCols() const { return cols; }
+        int getWordsPerRow() const { return wordsPerRow; }
+
+        bool isWall(int r, int c) const { return row(r)[c / 64] >> (c % 64) & 1; }
+        void setWall(int r, int c, bool wall);
+
+        // bit i of word k is the cell in column 64 * k + i
+        std::uint64_t       * row(int r)       { return words.data() + std::size_t(r) * wordsPerRow; }
+        std::uint64_t const * row(int r) const { return words.data() + std::size_t(r) * wordsPerRow; }
+
+        // sets the padding bits of the last word of every row back to walls
+        void fixPadding();
+
+    private:
+        int rows;
+        int cols;
+        int wordsPerRow;
+        std::vector<std::uint64_t> words;
+    };
+
+    // Bit n of `birth` turns floor with n wall neighbours into wall,
+    // bit n of `survival` keeps a wall with n wall neighbours
+    struct CaveRule {
+        std::uint16_t birth;
+        std::uint16_t survival;
+    };
+
+    // B5678/S45678: smooth open caves out of 45% noise in a few steps
+    CaveRule const CAVE_RULE{ 0b111100000, 0b111110000 };
+    int const CAVE_STEPS = 5;
+
+    // Fills the grid with walls at probability 7/16 and closes the border
+    void fillCaveNoise(BitGrid & grid, LevelRandom & random);
+
+    // One step of the automaton from `from` into `to`, both of the same size
+    void stepCaves(BitGrid const & from, BitGrid & to, CaveRule rule);
+
+    // Walls up every open region but the largest one, so the whole cave is reachable.
+    // Returns the floor cells left
+    int keepLargestCave(BitGrid & grid);
+
+    // Noise, CAVE_STEPS steps, then the largest cave. Tries again with the next noise
+    // while the cave takes less than a third of the map, a few times at most
+    void generateCaves(BitGrid & grid, LevelRandom & random);
+
+    // Writes a new cave level into `level`
+    template<std::size_t Rows, std::size_t Cols>
+    void generateCaves(Array2D<Tile, Rows, Cols> & level, LevelRandom & random) {
+        BitGrid grid(Rows, Cols);
+        generateCaves(grid, random);
+        for (std::size_t r = 0; r < Rows; ++r)
+            for (std::size_t c = 0; c < Cols; ++c)
+                level.at(r, c) = grid.isWall(r, c) ? tile::WALL : tile::FLOOR;
+    }
+} // namespace gen
+
+#endif // RLRPG_GEN_CAVES_HPP
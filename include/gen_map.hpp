@@ -1,7 +1,41 @@
 #ifndef GEN_MAP_HPP
 #define GEN_MAP_HPP
 
-void generateMaze();
+#include<array2d.hpp>
+#include<level_random.hpp>
+#include<tile_types.hpp>
 
-#endif // GEN_MAP_HPP
+#include<cstdint>
+
+namespace gen {
+    int const ROOMS_COUNT = 3;
+
+    // The maze generators work on `rows * cols` tiles, row by row, of any size known at run time.
+    // Maze cells are the odd level cells, walls between them are the even ones.
+
+    // Carves a perfect maze with a randomized depth-first search over an explicit stack, so
+    // the map size is only limited by memory. Everything it uses is local, generators can run
+    // on several threads at once.
+    void carveMaze(Tile * tiles, int rows, int cols, LevelRandom & random);
+
+    // Clears ROOMS_COUNT small rectangular rooms aligned to the maze cells
+    void carveRooms(Tile * tiles, int rows, int cols, LevelRandom & random);
 
+    // Writes a new maze with rooms into `tiles`
+    void generateMaze(Tile * tiles, int rows, int cols, LevelRandom & random);
+
+    // Writes a new maze with rooms into `level`
+    template<std::size_t Rows, std::size_t Cols>
+    void generateMaze(Array2D<Tile, Rows, Cols> & level, LevelRandom & random) {
+        // Array2D keeps its rows back to back
+        generateMaze(&level.at(0, 0), Rows, Cols, random);
+    }
+
+    template<std::size_t Rows, std::size_t Cols>
+    void generateMaze(Array2D<Tile, Rows, Cols> & level, std::uint64_t seed) {
+        LevelRandom random(seed);
+        generateMaze(level, random);
+    }
+} // namespace gen
+
+#endif // GEN_MAP_HPP
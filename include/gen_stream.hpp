@@ -0,0 +1,24 @@
+#ifndef RLRPG_GEN_STREAM_HPP
+#define RLRPG_GEN_STREAM_HPP
+
+#include<tile_types.hpp>
+
+#include<cstdint>
+#include<functional>
+
+// Maze generation for maps too large to keep in memory. Rows are produced top to bottom
+// with Eller's algorithm, which only remembers the sets of the previous maze row, so memory
+// stays O(cols) no matter how many rows the map has. Output uses the same tiles and layout
+// as gen::generateMaze: maze cells on odd coordinates, walls around the border.
+// tools/maze_stream writes such mazes into level files.
+namespace gen {
+    // Rooms are carved inside bands of this many maze rows, so a band is buffered before output
+    int const BAND_MAZE_ROWS = 10;
+
+    // Receives finished level rows top to bottom, `cells` points to `cols` tiles
+    using RowSink = std::function<void(int row, Tile const * cells)>;
+
+    void streamMaze(int rows, int cols, std::uint64_t seed, RowSink const & sink);
+} // namespace gen
+
+#endif // RLRPG_GEN_STREAM_HPP
@@ -2,15 +2,19 @@
 #define INVENTORY_HPP
 
 #include<inventory_iterator.hpp>
+#include<items/item.hpp>
 #include<ptr.hpp>
+#include<type_id.hpp>
 
+#include<array>
+#include<cstdint>
 #include<optional>
-#include<unordered_map>
+#include<string>
+#include<utility>
 #include<variant>
+#include<vector>
 #include<memory>
 
-class Item;
-
 class AddStatus {
 public:
     struct AddError {};
@@ -53,11 +57,13 @@ private:
     std::variant<AddError, New, Stacked> value;
 };
 
+// Copies share their items until one of them is detached (copy on write). Detaching clones
+// the items, so pointers to them must be looked up again; units do that in
+// Unit::detachInventory(). Changing or non-const access to a shared inventory is a bug
+// and throws std::logic_error, it never detaches behind the back of the owner.
 class Inventory {
 public:
-    Inventory() = default;
-    Inventory(Inventory const & other);
-    Inventory & operator =(Inventory const & other);
+    Inventory();
 
     // template because unique_ptr actually moves if needs to cast Ptr<Derived> to Ptr<Base>
     template<class ItemType>
@@ -71,6 +77,26 @@ public:
 
     InventoryIterator erase(ConstInventoryIterator iter);
 
+    // Uses up `count` items of the stack at `id`, the item is removed when none are left.
+    // Returns false if it was removed
+    bool consume(char id, int count = 1);
+
+    // Takes `count` items of the stack at `id` as a separate item, the whole item if that's all of them
+    Ptr<Item> split(char id, int count);
+
+    // Counts of stackable items must be changed only through the methods above,
+    // so these stay in sync with the items
+    int getTotalWeight() const { return storage->totalWeight; }
+    int countOf(TypeID typeID) const;
+    int countOf(Item::Type type) const { return storage->categoryCounts[static_cast<int>(type)]; }
+    bool contains(TypeID typeID) const { return countOf(typeID) > 0; }
+
+    // true if the items are shared with a copy of this inventory
+    bool isShared() const { return storage.use_count() > 1; }
+
+    // gives this inventory its own copy of the items, returns true if they had to be cloned
+    bool detach();
+
     int size() const;
     bool isFull() const;
     bool isEmpty() const;
@@ -90,7 +116,33 @@ public:
     ConstInventoryIterator cend() const;
 
 private:
-    std::unordered_map<char, Ptr<Item>> items;
+    struct Storage {
+        std::array<Ptr<Item>, inventory_slots::COUNT> slots;
+        std::uint64_t occupied = 0;
+
+        // id -> slot of a stackable item with that id, so stacking doesn't look through every slot
+        std::vector<std::pair<TypeID, int>> stacks;
+
+        int totalWeight = 0;
+        std::array<int, Item::TYPE_COUNT> categoryCounts{};
+        std::vector<int> typeCounts; // by TypeID
+
+        std::shared_ptr<Storage> clone() const;
+    };
+
+    // storage for changing, throws if it is shared with a copy
+    Storage & own();
+
+    // puts the item to a free slot, returns its symbol
+    char place(Ptr<Item> item, int slot);
+    Ptr<Item> take(int slot);
+    int findStack(TypeID typeID) const;
+
+    // adds `count` items of the type of `item` to the aggregates, negative to subtract
+    void account(Item const & item, int count);
+    void checkAggregates() const;
+
+    std::shared_ptr<Storage> storage;
 };
 
 #include<inventory.inl>
@@ -7,30 +7,25 @@ AddStatus Inventory::add(Ptr<ItemType> && item) {
     if (not item)
         throw std::logic_error("Trying to add empty item to the inventory");
 
-    if (item->isStackable) {
-        for (auto & pair : items) {
-            if (pair.second->id == item->id) {
-                pair.second->count += item->count;
-                return AddStatus::Stacked{ pair.first, item->count };
-            }
+    auto & data = own();
+    if (item->isStackable()) {
+        int slot = findStack(item->getTypeID());
+        if (slot != -1) {
+            data.slots[slot]->count += item->count;
+            account(*item, item->count);
+            checkAggregates();
+            return AddStatus::Stacked{ inventory_slots::toSymbol(slot), item->count };
         }
     }
 
-    for (char i = 'a'; i <= 'z'; ++i) {
-        if (items.count(i) == 0) {
-            item->inventorySymbol = i;
-            items[i] = std::move(item);
-            return AddStatus::New{ i };
-        }
-    }
-    for (char i = 'A'; i <= 'Z'; ++i) {
-        if (items.count(i) == 0) {
-            item->inventorySymbol = i;
-            items[i] = std::move(item);
-            return AddStatus::New{ i };
-        }
-    }
-    return AddStatus::AddError{};
+    std::uint64_t freeSlots = ~data.occupied & inventory_slots::ALL;
+    if (freeSlots == 0)
+        return AddStatus::AddError{};
+
+    // lowercase letters are given out first
+    if (freeSlots & inventory_slots::LOWERCASE)
+        freeSlots &= inventory_slots::LOWERCASE;
+    return AddStatus::New{ place(std::move(item), inventory_slots::lowest(freeSlots)) };
 }
 
 template<class ItemType>
@@ -38,18 +33,20 @@ AddStatus Inventory::add(Ptr<ItemType> && item, char at) {
     if (not item)
         throw std::logic_error("Trying to add empty item to the inventory");
 
-    auto iter = items.find(at);
-    if (iter == items.end()) {
-        item->inventorySymbol = at;
-        items[at] = std::move(item);
-        return AddStatus::New{ at };
-    }
+    int slot = inventory_slots::toSlot(at);
+    if (slot == -1)
+        return AddStatus::AddError{};
 
-    if (item->id != iter->second->id or not item->isStackable) {
+    auto & data = own();
+    if (not data.slots[slot])
+        return AddStatus::New{ place(std::move(item), slot) };
+
+    if (item->getTypeID() != data.slots[slot]->getTypeID() or not item->isStackable()) {
         return AddStatus::AddError{};
     }
 
-    iter->second->count += item->count;
+    data.slots[slot]->count += item->count;
+    account(*item, item->count);
+    checkAggregates();
     return AddStatus::Stacked{ at, item->count };
 }
-
@@ -3,64 +3,102 @@
 
 #include<ptr.hpp>
 
+#include<cstdint>
 #include<iterator>
-#include<unordered_map>
 #include<type_traits>
 #include<memory>
 
 class Item;
 
-template<class UnderlyingIter, class ItemType, class ValueType = std::pair<char, ItemType *>>
+namespace inventory_slots {
+    int const COUNT = 52;
+
+    // slots are ordered like the inventory symbols themselves: 'A'..'Z', then 'a'..'z'
+    std::uint64_t const ALL = (std::uint64_t(1) << COUNT) - 1;
+    std::uint64_t const UPPERCASE = (std::uint64_t(1) << 26) - 1;
+    std::uint64_t const LOWERCASE = ALL & ~UPPERCASE;
+
+    inline int toSlot(char symbol) {
+        if (symbol >= 'A' and symbol <= 'Z')
+            return symbol - 'A';
+        if (symbol >= 'a' and symbol <= 'z')
+            return symbol - 'a' + 26;
+        return -1;
+    }
+
+    inline char toSymbol(int slot) {
+        return static_cast<char>(slot < 26 ? 'A' + slot : 'a' + slot - 26);
+    }
+
+    inline std::uint64_t bit(int slot) {
+        return std::uint64_t(1) << slot;
+    }
+
+    // mask must not be zero
+    inline int lowest(std::uint64_t mask) {
+        return __builtin_ctzll(mask);
+    }
+}
+
+// Walks occupied slots in the order of their symbols
+template<class ItemType, class ValueType = std::pair<char, ItemType *>>
 class InventoryIteratorImpl {
     friend class Inventory;
 
-    //using ItemType = typename UnderlyingIter::value_type::second_type::element_type;
+    template<class OtherItemType, class OtherValueType>
+    friend class InventoryIteratorImpl;
+
+    using Slot = std::conditional_t<std::is_const_v<ItemType>, Ptr<Item> const, Ptr<Item>>;
 
-    UnderlyingIter iter;
+    Slot * slots;
+    std::uint64_t remaining;
     mutable ValueType value;
 
-    InventoryIteratorImpl(UnderlyingIter iter): iter(iter) {}
+    InventoryIteratorImpl(Slot * slots, std::uint64_t remaining)
+        : slots(slots)
+        , remaining(remaining) {}
+
+    int slot() const {
+        return inventory_slots::lowest(remaining);
+    }
 
 public:
     ValueType operator *() const {
-        return std::make_pair(iter->first, iter->second.get());
+        return std::make_pair(inventory_slots::toSymbol(slot()), slots[slot()].get());
     }
 
     ValueType * operator ->() const {
-        value = std::make_pair(iter->first, iter->second.get());
+        value = **this;
         return &value;
-        //return std::make_pair<*iter->second;
     }
 
     InventoryIteratorImpl & operator ++() {
-        ++iter;
+        remaining &= remaining - 1;
         return *this;
     }
 
     InventoryIteratorImpl operator ++(int) {
         auto old = *this;
-        iter++;
+        ++*this;
         return old;
     }
 
-    template<class OtherIter, class OtherItemType>
-    bool operator ==(InventoryIteratorImpl<OtherIter, OtherItemType> const & other) const {
-        return iter == other.iter;
+    template<class OtherItemType>
+    bool operator ==(InventoryIteratorImpl<OtherItemType> const & other) const {
+        return remaining == other.remaining;
     }
 
-    template<class OtherIter, class OtherItemType>
-    bool operator !=(InventoryIteratorImpl<OtherIter, OtherItemType> const & other) const {
-        return iter != other.iter;
+    template<class OtherItemType>
+    bool operator !=(InventoryIteratorImpl<OtherItemType> const & other) const {
+        return remaining != other.remaining;
     }
 
-    template<class OtherIter>
-    operator InventoryIteratorImpl<OtherIter, ItemType const>() const {
-        return InventoryIteratorImpl<OtherIter, ItemType const>(iter);
+    operator InventoryIteratorImpl<ItemType const>() const {
+        return InventoryIteratorImpl<ItemType const>(slots, remaining);
     }
 };
 
-using InventoryIterator = InventoryIteratorImpl<std::unordered_map<char, Ptr<Item>>::iterator, Item>;
-using ConstInventoryIterator = InventoryIteratorImpl<std::unordered_map<char, Ptr<Item>>::const_iterator, Item const>;
+using InventoryIterator = InventoryIteratorImpl<Item>;
+using ConstInventoryIterator = InventoryIteratorImpl<Item const>;
 
 #endif // INVENTORY_ITERATOR_HPP
-
@@ -10,6 +10,7 @@
 #include<items/armor.hpp>
 
 #include<cassert>
+#include<string_view>
 #include<fmt/core.h>
 
 namespace formatters {
@@ -66,11 +67,12 @@ namespace formatters {
 
 }
 
+// `itemName` is what the player knows the item as, see Game::getItemName()
 template<class NS, class MS, class ES>
-std::string formatItem(int i, Item const & item,
+std::string formatItem(int i, Item const & item, std::string_view itemName,
                        NS numberingStrategy, MS markStrategy, ES equippedStrategy) {
     using fmt::format;
-    std::string name = format(" {}", item.getName());
+    std::string name = format(" {}", itemName);
 
     std::string count;
     if (item.count > 1)
@@ -0,0 +1,54 @@
+#ifndef RLRPG_ITEM_PILES_HPP
+#define RLRPG_ITEM_PILES_HPP
+
+#include<level.hpp>
+#include<ptr.hpp>
+
+#include<termlib/vec2.hpp>
+
+#include<vector>
+#include<unordered_map>
+#include<bitset>
+
+class Item;
+
+using ItemPile = std::vector<Ptr<Item>>;
+
+//////////////////////////////////////////////////
+// Items lying on the level. Only cells that have items own a pile, and a bit per cell
+// tells whether there is one, so empty cells cost a bit instead of a container.
+// Items keep the order they were dropped in.
+class ItemPiles {
+public:
+    bool hasItems(Coord2i cell) const { return occupied[toIndex(cell)]; }
+
+    int count(Coord2i cell) const;
+
+    // empty pile if there are no items in the cell
+    ItemPile const & operator [](Coord2i cell) const;
+
+    // the pointer may be moved from, as long as `erase` removes it afterwards
+    Ptr<Item> & at(Coord2i cell, int index);
+
+    void add(Coord2i cell, Ptr<Item> item);
+
+    // removes items at `indices` (sorted ascending), keeps the order of the rest
+    void erase(Coord2i cell, std::vector<int> const & indices);
+
+    void clear();
+
+    template<class Fn>
+    void forEach(Fn && onPile) const {
+        for (auto const & [index, pile] : piles)
+            onPile(toCell(index), pile);
+    }
+
+private:
+    static int toIndex(Coord2i cell) { return cell.y * LEVEL_COLS + cell.x; }
+    static Coord2i toCell(int index) { return Coord2i{ index % LEVEL_COLS, index / LEVEL_COLS }; }
+
+    std::unordered_map<int, ItemPile> piles; // by cell index
+    std::bitset<LEVEL_ROWS * LEVEL_COLS> occupied;
+};
+
+#endif // RLRPG_ITEM_PILES_HPP
@@ -10,8 +10,6 @@ class Ammo
     , public EnableClone<Ammo>
 {
 public:
-    static int const COUNT = 25;
-
     int range;
     int damage;
 
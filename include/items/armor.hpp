@@ -10,8 +10,6 @@ class Armor
     , public EnableClone<Armor>
 {
 public:
-    static int const COUNT = 4;
-
     int defence;
     int durability;
 
@@ -10,8 +10,6 @@ class Food
     , public EnableClone<Food>
 {
 public:
-    static int const COUNT = 10;
-
     int nutritionalValue;
     bool isRotten = false;
 
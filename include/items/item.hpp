@@ -2,11 +2,22 @@
 #define RLRPG_ITEMS_ITEM_HPP
 
 #include<ptr.hpp>
+#include<object_pool.hpp>
+#include<type_id.hpp>
 
 #include<termlib/vec2.hpp>
 
 #include<string>
 
+// Everything that is the same for all items of one type. Loaded once, items only point to it
+struct ItemTypeInfo {
+    TypeID typeID;
+    std::string id;
+    std::string name;
+    int weight;
+    bool isStackable;
+};
+
 class Item {
 public:
     enum class Type {
@@ -18,17 +29,24 @@ public:
         Potion
     };
 
+    static int const TYPE_COUNT = static_cast<int>(Type::Potion) + 1;
+
     virtual ~Item() = default;
 
+    // items are created and dropped in bulk with every level, so they live in pool::
+    static void * operator new(std::size_t size) { return pool::allocate(size); }
+    static void operator delete(void * ptr, std::size_t size) { pool::deallocate(ptr, size); }
+
     Coord2i pos;
-    std::string id;
-    std::string name;
+    ItemTypeInfo const * typeInfo = nullptr;
     char inventorySymbol;
-    int weight;
     int mdf = 1;
     int count = 1;
     bool showMdf = false;
-    bool isStackable;
+
+    TypeID getTypeID() const { return typeInfo->typeID; }
+    std::string const & getID() const { return typeInfo->id; }
+    bool isStackable() const { return typeInfo->isStackable; }
 
     // toSplit:
     //  - [1, count) - splits on 2 piles, returns one with count = toSplit
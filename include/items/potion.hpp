@@ -10,8 +10,7 @@ class Potion
     , public EnableClone<Potion>
 {
 public:
-    static int const COUNT = 25; /* IT TOO */
-
+    // which type does what is rolled for every game, see Game::getPotionEffect()
     enum Effect {
         None,
         Heal,
@@ -21,10 +20,6 @@ public:
         EffectCount
     };
 
-    Effect effect;
-
-    std::string getName() const override;
-
     Type getType() const override {
         return Type::Potion;
     }
@@ -10,8 +10,6 @@ class Scroll
     , public EnableClone<Scroll>
 {
 public:
-    static int const COUNT = 15; /* JUST FOR !DEBUG!!*/
-
     enum Effect {
         Map,
         Identify,
@@ -13,27 +13,39 @@ class Weapon
     , public EnableClone<Weapon>
 {
 public:
+    // Loaded rounds are kept as runs of the same ammo type, the last run is fired first
     class Cartridge {
-        std::vector<Ptr<Ammo>> loaded;
+    public:
+        struct Run {
+            Ammo const * ammo; // prototype of the ammo type
+            int count;
+        };
+
+    private:
+        std::vector<Run> runs;
+        int size = 0;
         int capacity = 0;
 
     public:
         explicit Cartridge(int capacity = 0);
-        Cartridge(Cartridge const &);
-        Cartridge & operator =(Cartridge const &);
 
-        // returns the bullet if fails to load it
-        Ptr<Ammo> load(Ptr<Ammo> bullet);
+        // Loads up to `count` rounds of `prototype`, returns how many were loaded. The runs point
+        // to the prototype, so it has to be the one of the game data
+        int load(Ammo const & prototype, int count = 1);
 
+        // returns the last loaded round as a new item, nullptr if the cartridge is empty
         Ptr<Ammo> unloadOne();
 
+        // removes the last loaded round without creating an item for it
+        void fireOne();
+
         Ammo const & next() const;
-        Ammo       & next();
 
+        // prototype of the round at `ind`, counting from the first loaded one; nullptr if there is none
         Ammo const * operator [](int ind) const;
 
-        auto begin() const -> decltype(loaded.begin());
-        auto end()   const -> decltype(loaded.end());
+        auto begin() const -> decltype(runs.begin());
+        auto end()   const -> decltype(runs.end());
 
         int getCapacity() const;
         int getCurrSize() const;
@@ -41,8 +53,6 @@ public:
         bool isFull() const;
     };
 
-    static int const COUNT = 25; /* JUST FOR !DEBUG!!*/
-
     Cartridge cartridge;
     int damage;
     int range;                                     // Ranged bullets have additional effect on this paramether
@@ -2,11 +2,12 @@
 #define RLRPG_LEVEL_HPP
 
 #include<array2d.hpp>
+#include<tile_types.hpp>
 
 const int LEVEL_COLS = 81;
 const int LEVEL_ROWS = 21;
 
-using LevelData = Array2D<int, LEVEL_ROWS, LEVEL_COLS>;
+using LevelData = Array2D<Tile, LEVEL_ROWS, LEVEL_COLS>;
 
 #endif // RLRPG_LEVEL_HPP
 
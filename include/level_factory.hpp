@@ -0,0 +1,103 @@
+#ifndef RLRPG_LEVEL_FACTORY_HPP
+#define RLRPG_LEVEL_FACTORY_HPP
+
+#include<dungeon_level.hpp>
+#include<floor_archive.hpp>
+#include<level_random.hpp>
+#include<ptr.hpp>
+
+#include<cstdint>
+#include<future>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<deque>
+
+class GameData;
+class LevelFile;
+
+// What new levels are generated as, the first one can be loaded from a file instead
+enum class LevelGenerator {
+    Maze,
+    Caves
+};
+
+//////////////////////////////////////////////////
+// Builds dungeon levels: terrain, items and enemies. Building only reads the loaded game data
+// and draws from its own LevelRandom, it never touches a game or the random engine of a thread,
+// so the next level can be built on a worker thread while the current one is played.
+//
+// The worker is one thread for the whole game, started by the first job. Levels it builds are
+// allocated from its pool:: free lists, so used levels are handed back to it to be destroyed,
+// and the next level reuses their blocks. Without the background the jobs are done right away
+// on the thread that asks for them.
+class LevelFactory {
+public:
+    explicit LevelFactory(GameData const & data): data(data) {}
+
+    // finishes the queued jobs, they read the game data
+    ~LevelFactory();
+
+    LevelFactory(LevelFactory const &) = delete;
+    LevelFactory & operator=(LevelFactory const &) = delete;
+
+    // set before the first level is built
+    LevelGenerator getGenerator() const { return generator; }
+    void setGenerator(LevelGenerator newGenerator) { generator = newGenerator; }
+
+    bool isBackground() const { return background; }
+    void setBackground(bool inBackground) { background = inBackground; }
+
+    // Generates the terrain of the generator that is set. `heroLuck` affects the items,
+    // `seed` decides everything else
+    Ptr<DungeonLevel> build(int depth, int heroLuck, std::uint64_t seed) const;
+
+    // Same, but keeps the terrain of the file instead of generating a maze. A file
+    // with spawns gets exactly those instead of the random items and enemies
+    Ptr<DungeonLevel> build(LevelFile const & file, int depth, int heroLuck, std::uint64_t seed) const;
+
+    // Starts building a level on the worker thread. A level prepared earlier and not taken is dropped,
+    // unless it is the same one
+    void prepare(int depth, int heroLuck, std::uint64_t seed);
+
+    // unpacks the floor on the worker thread and waits for it
+    Ptr<DungeonLevel> restore(PackedFloor packed);
+
+    // destroys the level on the worker thread
+    void retire(Ptr<DungeonLevel> level);
+
+    bool isPrepared(int depth) const { return next.valid() and preparedDepth == depth; }
+
+    // The level started by prepare(), waits for the worker if it isn't done yet.
+    // Rethrows whatever the worker threw
+    Ptr<DungeonLevel> take();
+
+private:
+    using Job = std::packaged_task<Ptr<DungeonLevel>()>;
+
+    void populate(DungeonLevel & level, int heroLuck, LevelRandom & random) const;
+    void placeStairs(DungeonLevel & level, LevelRandom & random) const;
+    void placeSpawns(DungeonLevel & level, LevelFile const & file) const;
+    // the entrance has to be out of the free cells, it is left for the hero
+    void spawnEnemies(DungeonLevel & level, LevelRandom & random) const;
+    void spawnItems(DungeonLevel & level, int heroLuck, LevelRandom & random) const;
+
+    void push(Job job);
+    void work();
+
+    GameData const & data;
+    LevelGenerator generator = LevelGenerator::Maze;
+    bool background = true;
+
+    std::future<Ptr<DungeonLevel>> next;
+    int preparedDepth = 0;
+    std::uint64_t preparedSeed = 0;
+
+    std::thread worker;
+    std::mutex jobsMutex;
+    std::condition_variable jobsChanged;
+    std::deque<Job> jobs;
+    bool stopping = false;
+};
+
+#endif // RLRPG_LEVEL_FACTORY_HPP
@@ -0,0 +1,74 @@
+#ifndef RLRPG_LEVEL_FILE_HPP
+#define RLRPG_LEVEL_FILE_HPP
+
+#include<level.hpp>
+#include<mapped_file.hpp>
+
+#include<termlib/vec2.hpp>
+
+#include<cstdint>
+#include<ostream>
+#include<string>
+#include<string_view>
+#include<vector>
+
+// an item or an enemy placed by hand, instead of the random ones
+struct LevelSpawn {
+    enum class Kind : std::uint8_t {
+        Item,
+        Enemy
+    };
+
+    Kind kind = Kind::Item;
+    std::string_view id;
+    Coord2i cell;
+    int count = 1; // of a stackable item
+};
+
+//////////////////////////////////////////////////
+// Handcrafted level in the binary format. All numbers are little-endian:
+//
+//     "RLLV", u32 version, u32 rows, u32 cols, u32 spawn count
+//     rows * cols tiles, a byte each, row by row
+//     spawns: u8 kind, u8 id length, u16 row, u16 col, u16 count, id
+//
+// The file is mapped and checked once when opened, its tiles against the given tile types.
+// Tiles and spawn ids are then read straight from the mapping, nothing is parsed into
+// a buffer first.
+class LevelFile {
+public:
+    static constexpr std::uint32_t VERSION = 1;
+
+    // the largest number of rows or cols a file may have
+    static constexpr int MAX_SIDE = INT16_MAX;
+
+    LevelFile(std::string const & filename, TileTypes const & tileTypes);
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+
+    Tile tileAt(int row, int col) const { return tiles[row * cols + col]; }
+
+    // the ids point into the file, they live as long as this object
+    std::vector<LevelSpawn> const & getSpawns() const { return spawns; }
+
+    // the file must be of the level size
+    void copyTiles(LevelData & level) const;
+
+private:
+    MappedFile file;
+    int rows = 0;
+    int cols = 0;
+    std::uint8_t const * tiles = nullptr;
+    std::vector<LevelSpawn> spawns;
+};
+
+// `tiles` are rows * cols bytes, row by row. Ids are at most 255 bytes
+void writeLevelFile(std::ostream & out, int rows, int cols, std::uint8_t const * tiles,
+        std::vector<LevelSpawn> const & spawns);
+
+// Writes the header of a level without spawns, for writers that produce the tiles a row
+// at a time. The rows * cols tiles have to follow
+void writeLevelHeader(std::ostream & out, int rows, int cols);
+
+#endif // RLRPG_LEVEL_FILE_HPP
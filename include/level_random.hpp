@@ -0,0 +1,44 @@
+#ifndef RLRPG_LEVEL_RANDOM_HPP
+#define RLRPG_LEVEL_RANDOM_HPP
+
+#include<cstdint>
+
+//////////////////////////////////////////////////
+// Random numbers for everything that builds a level. SplitMix64: the state is one integer,
+// so every level gets its own generator for free, levels can be built on several threads
+// at once, and the same seed gives the same level on every platform.
+class LevelRandom {
+public:
+    explicit LevelRandom(std::uint64_t seed): state(seed) {}
+
+    std::uint32_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::uint32_t>((z ^ (z >> 31)) >> 32);
+    }
+
+    // uniform in [0, n), n must be positive
+    int below(int n) {
+        return static_cast<int>((std::uint64_t(next()) * n) >> 32);
+    }
+
+    // uniform in [from, to]
+    int between(int from, int to) {
+        return from + below(to - from + 1);
+    }
+
+    // uniform in [0, 1)
+    double real() {
+        return next() * (1.0 / 4294967296.0);
+    }
+
+    bool chance(double probability) {
+        return real() < probability;
+    }
+
+private:
+    std::uint64_t state;
+};
+
+#endif // RLRPG_LEVEL_RANDOM_HPP
@@ -0,0 +1,101 @@
+#ifndef RLRPG_LINE_OF_SIGHT_HPP
+#define RLRPG_LINE_OF_SIGHT_HPP
+
+#include<level.hpp>
+
+#include<termlib/vec2.hpp>
+
+namespace los {
+    // Rays are cast from the center of a cell to points near the corners of another one.
+    // The corners are moved inside the cell by 1 / PRECISION of its size.
+    int const PRECISION = 256;
+
+    // All ray math is done in fixed point, one cell is SCALE units long
+    int const SCALE = 2 * PRECISION;
+
+    inline bool isOpaque(LevelData const & level, TileTypes const & tileTypes, Coord2i cell) {
+        return tileTypes.isOpaque(level[cell]);
+    }
+
+    namespace detail {
+        constexpr long long floorDiv(long long num, long long den) {
+            if (den < 0) {
+                num = -num;
+                den = -den;
+            }
+            long long quot = num / den;
+            if (num % den != 0 and num < 0)
+                --quot;
+            return quot;
+        }
+    }
+
+    // Steps the ray from the fixed point (fromX, fromY) to the fixed point (toX, toY), both in SCALE
+    // units, cell by cell along its major axis and calls `onCell(x, y)` for every cell. Stops and
+    // returns false as soon as `onCell` returns false.
+    // constexpr, so the same stepping is used to precompute ray tables (see fov_table.hpp)
+    template<class Fn>
+    constexpr bool walkRay(long long fromX, long long fromY, long long toX, long long toY, Fn && onCell) {
+        long long dx = toX - fromX;
+        long long dy = toY - fromY;
+        bool steep = (dx < 0 ? -dx : dx) < (dy < 0 ? -dy : dy);
+        if (steep) {
+            long long t = dx; dx = dy; dy = t;
+            t = fromX; fromX = fromY; fromY = t;
+        }
+        // the line is y = fromY + (x - fromX) * dy / dx; its cell row is kept as
+        // an integer quotient plus a remainder, so each step is just an addition
+        long long s = dx > 0 ? 1 : -1;
+        long long denominator = SCALE * dx;
+        long long step = SCALE * dy * s;
+        long long numerator = fromY * dx;
+        if (denominator < 0) {
+            denominator = -denominator;
+            step = -step;
+            numerator = -numerator;
+        }
+        long long row = detail::floorDiv(numerator, denominator);
+        long long remainder = numerator - row * denominator;
+        long long const startCol = detail::floorDiv(fromX, SCALE);
+        for (long long i = 0; i * s * SCALE < dx * s; i += s) {
+            long long col = startCol + i;
+            if (not (steep ? onCell(row, col) : onCell(col, row)))
+                return false;
+            // |step| <= denominator because the ray is not steep, so the row changes by one at most
+            remainder += step;
+            if (remainder >= denominator) {
+                remainder -= denominator;
+                ++row;
+            } else if (remainder < 0) {
+                remainder += denominator;
+                --row;
+            }
+        }
+        return true;
+    }
+
+    // Returns false if the ray from the fixed point `from` to the fixed point `to` meets an opaque cell
+    bool isRayClear(LevelData const & level, TileTypes const & tileTypes, Vec2<long long> from, Vec2<long long> to);
+
+    // Returns true if at least one of the four rays from the center of `from` to `to`'s corners is clear
+    bool isVisible(LevelData const & level, TileTypes const & tileTypes, Coord2i from, Coord2i to);
+
+    // Walks a straight projectile line `from + offset * i` for i in [1, length), stopping
+    // before the first opaque cell. `onCell(cell, i)` returns false to stop the flight.
+    // Returns the number of cells passed.
+    template<class Fn>
+    int traceProjectile(LevelData const & level, TileTypes const & tileTypes, Coord2i from, Vec2i offset, int length, Fn && onCell) {
+        int passed = 0;
+        for (int i = 1; i < length; ++i) {
+            Coord2i cell = from + offset * i;
+            if (not level.isIndex(cell) or isOpaque(level, tileTypes, cell))
+                break;
+            if (not onCell(cell, i))
+                break;
+            ++passed;
+        }
+        return passed;
+    }
+} // namespace los
+
+#endif // RLRPG_LINE_OF_SIGHT_HPP
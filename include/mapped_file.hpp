@@ -0,0 +1,28 @@
+#ifndef RLRPG_MAPPED_FILE_HPP
+#define RLRPG_MAPPED_FILE_HPP
+
+#include<cstddef>
+#include<cstdint>
+#include<string>
+
+//////////////////////////////////////////////////
+// A whole file mapped read-only into memory. Nothing is read up front,
+// the OS pages the file in as its bytes are touched.
+class MappedFile {
+public:
+    explicit MappedFile(std::string const & filename);
+    ~MappedFile();
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile & operator=(MappedFile const &) = delete;
+
+    // nullptr for an empty file
+    std::uint8_t const * data() const { return static_cast<std::uint8_t const *>(address); }
+    std::size_t size() const { return length; }
+
+private:
+    void * address = nullptr;
+    std::size_t length = 0;
+};
+
+#endif // RLRPG_MAPPED_FILE_HPP
@@ -0,0 +1,36 @@
+#ifndef RLRPG_OBJECT_POOL_HPP
+#define RLRPG_OBJECT_POOL_HPP
+
+#include<cstddef>
+
+//////////////////////////////////////////////////
+// Size-class pools for game objects (items and units), used by their class-specific
+// operator new and delete. Freed blocks go to a free list of their size class and are
+// reused by the next allocation of that size, so dropping a level and spawning the next
+// one doesn't touch the global heap. Blocks are carved from big chunks with a pointer bump.
+//
+// Every thread allocates from a pool of its own, without locks. A block belongs to the pool
+// whose chunk it was cut from: freed on another thread it is passed back to that pool, which
+// takes it up when its own free list runs out, so levels built on one thread and dropped on
+// another don't make the pools grow. The pool of a thread that ends goes to the next thread
+// that starts allocating, with the blocks still in use and the ones freed meanwhile.
+namespace pool {
+    // objects larger than this go to the global heap
+    std::size_t const MAX_POOLED_SIZE = 1024;
+
+    void * allocate(std::size_t size);
+    void deallocate(void * ptr, std::size_t size) noexcept;
+
+    struct Stats {
+        long long allocations = 0;  // served from a free list or a chunk
+        long long reused = 0;       // served from a free list
+        long long remoteFrees = 0;  // blocks freed on another thread than their pool's
+        long long chunks = 0;       // chunks taken from the global heap
+        int pools = 0;
+    };
+
+    // statistics of all the pools together
+    Stats getStats();
+} // namespace pool
+
+#endif // RLRPG_OBJECT_POOL_HPP
@@ -2,17 +2,99 @@
 #define RLRPG_REGISTRY_HPP
 
 #include<enable_clone.hpp>
+#include<type_id.hpp>
 
 #include<effolkronium/random.hpp>
 
-#include<unordered_map>
+#include<vector>
+#include<utility>
 #include<functional>
+#include<stdexcept>
 
 namespace reg {
-    using DefaultIDType = std::string;
+    using DefaultIDType = TypeID;
+
+    ////////////////////
+    // Entries are stored contiguously in the order of insertion, and the position of each entry
+    // is indexed by the dense ID value. Lookups and random picks are O(1).
+    ////////////////////
+    template<class T, class ID = DefaultIDType>
+    class DenseRegistry {
+    public:
+        using value_type = std::pair<ID, T>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        iterator begin() { return entries.begin(); }
+        iterator end() { return entries.end(); }
+        const_iterator begin() const { return entries.begin(); }
+        const_iterator end() const { return entries.end(); }
+
+        int size() const { return static_cast<int>(entries.size()); }
+        bool empty() const { return entries.empty(); }
+
+        void clear() {
+            entries.clear();
+            positions.clear();
+        }
+
+        iterator find(ID id) {
+            int pos = positionOf(id);
+            return pos < 0 ? end() : begin() + pos;
+        }
+
+        const_iterator find(ID id) const {
+            int pos = positionOf(id);
+            return pos < 0 ? end() : begin() + pos;
+        }
+
+        int count(ID id) const { return positionOf(id) < 0 ? 0 : 1; }
+
+        T & at(ID id) {
+            return const_cast<T &>(static_cast<DenseRegistry const &>(*this).at(id));
+        }
+
+        T const & at(ID id) const {
+            int pos = positionOf(id);
+            if (pos < 0)
+                throw std::out_of_range("No registry entry with such ID");
+            return entries[pos].second;
+        }
+
+        T & operator [](ID id) {
+            int pos = positionOf(id);
+            if (pos >= 0)
+                return entries[pos].second;
+
+            if (positions.size() <= id.value)
+                positions.resize(id.value + 1, -1);
+            positions[id.value] = size();
+            entries.emplace_back(id, T{});
+            return entries.back().second;
+        }
+
+        // registry must not be empty
+        value_type & pickAny() {
+            return entries[effolkronium::random_thread_local::get<std::size_t>(0, entries.size() - 1)];
+        }
+
+        value_type const & pickAny() const {
+            return entries[effolkronium::random_thread_local::get<std::size_t>(0, entries.size() - 1)];
+        }
+
+    private:
+        int positionOf(ID id) const {
+            if (id.value < 0 or id.value >= positions.size())
+                return -1;
+            return positions[id.value];
+        }
+
+        std::vector<value_type> entries;
+        std::vector<int> positions; // by ID value, -1 if there is no entry
+    };
 
     template<class T, class ID = DefaultIDType>
-    using Registry = std::unordered_map<ID, T>;
+    using Registry = DenseRegistry<T, ID>;
 
     ////////////////////
     // Selectors select some registry item in some way (likely random)
@@ -61,31 +143,31 @@ namespace reg {
     // CosntRefSelector
     template<class T, class ID = DefaultIDType>
     T const & pickAnyCRef(Registry<T, ID> const & reg) {
-        return effolkronium::random_static::get(reg)->second;
+        return reg.pickAny().second;
     }
 
     // RefSelector
     template<class T, class ID = DefaultIDType>
     T & pickAnyRef(Registry<T, ID> & reg) {
-        return effolkronium::random_static::get(reg)->second;
+        return reg.pickAny().second;
     }
 
     // CopySelector
     template<class T, class ID = DefaultIDType>
     T pickAny(Registry<T, ID> const & reg) {
-        return effolkronium::random_static::get(reg)->second;
+        return reg.pickAny().second;
     }
 
     // MoveSelector
     template<class T, class ID = DefaultIDType>
     T pickAny(Registry<T, ID> && reg) {
-        return std::move(effolkronium::random_static::get(reg)->second);
+        return std::move(reg.pickAny().second);
     }
 
     // CloneSelector
     template<class T, class ID = DefaultIDType, meta::Check<IsClonable<T>> = meta::Checked>
     T pickAny(Registry<T, ID> && reg) {
-        return effolkronium::random_static::get(reg)->second.clone();
+        return reg.pickAny().second.clone();
     }
 } // namespace reg
 
@@ -3,35 +3,65 @@
 
 #include<termlib/terminal_text_style.hpp>
 
-#include<tl/optional.hpp>
+#include<cstdint>
 
-struct SymbolRenderData {
-    TextStyle style;
-    char symbol;
+//////////////////////////////////////////////////
+// What a map cell is drawn as, packed into four bytes: the glyph, the palette indices of
+// both colors, the text attributes and whether the cell stays on the remembered map once
+// it is out of view. Items, units and tiles keep their looks in these, and the remembered
+// map is a grid of them.
+class PackedCell {
+public:
+    // empty, drawn as a space
+    PackedCell() = default;
 
-    SymbolRenderData(char symbol, TextStyle style = {})
-        : symbol(symbol)
-        , style(style) {}
-};
+    PackedCell(char glyph, TextStyle style = {}, bool remembered = true)
+        : glyph(glyph)
+        , colors(static_cast<std::uint8_t>(static_cast<int>(style.getColor().fg)
+                    | static_cast<int>(style.getColor().bg) << 4))
+        , attributes(static_cast<std::uint8_t>(style.attributes))
+        , flags(static_cast<std::uint8_t>((style.hasColor() ? Colored : 0) | (remembered ? Remembered : 0))) {}
+
+    bool isEmpty() const { return glyph == 0; }
+
+    // the hero remembers items and tiles like walls, but not the floor
+    bool isRemembered() const { return flags & Remembered; }
 
-struct CellRenderData {
-    tl::optional<SymbolRenderData> level;
-    tl::optional<SymbolRenderData> item;
-    tl::optional<SymbolRenderData> unit;
+    char getGlyph() const { return isEmpty() ? ' ' : glyph; }
+
+    TextStyle getStyle() const {
+        if (not (flags & Colored))
+            return TextStyle{ attributes };
+        return TextStyle{ attributes, TerminalColor{ Color(colors & 0xF), Color(colors >> 4) } };
+    }
 
-    tl::optional<SymbolRenderData> get() const {
-        return unit.disjunction(item).disjunction(level);
+    // all four bytes as one number, to store cells and read them back
+    std::uint32_t toBits() const {
+        return std::uint32_t(std::uint8_t(glyph)) | std::uint32_t(colors) << 8
+            | std::uint32_t(attributes) << 16 | std::uint32_t(flags) << 24;
     }
 
-    CellRenderData forCache() const {
-        CellRenderData cached;
-        cached.item = item;
-        if (level.has_value() and level->symbol != '.') {
-            cached.level = level;
-        }
-        return cached;
+    static PackedCell fromBits(std::uint32_t bits) {
+        PackedCell cell;
+        cell.glyph = static_cast<char>(bits & 0xFF);
+        cell.colors = static_cast<std::uint8_t>(bits >> 8);
+        cell.attributes = static_cast<std::uint8_t>(bits >> 16);
+        cell.flags = static_cast<std::uint8_t>(bits >> 24);
+        return cell;
     }
+
+private:
+    enum Flags : std::uint8_t {
+        Colored = 1 << 0,   // without it the cell keeps the colors of the terminal
+        Remembered = 1 << 1
+    };
+
+    char glyph = 0;
+    std::uint8_t colors = 0;        // foreground in the low half, background in the high one
+    std::uint8_t attributes = 0;    // TextStyle::TextAttribute
+    std::uint8_t flags = 0;
 };
 
-#endif // RLRPG_RENDER_DATA_HPP
+static_assert(sizeof(PackedCell) == 4);
 
+#endif // RLRPG_RENDER_DATA_HPP
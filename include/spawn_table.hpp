@@ -0,0 +1,65 @@
+#ifndef RLRPG_SPAWN_TABLE_HPP
+#define RLRPG_SPAWN_TABLE_HPP
+
+#include<alias_table.hpp>
+#include<level_random.hpp>
+#include<type_id.hpp>
+
+#include<tl/optional.hpp>
+
+#include<vector>
+#include<climits>
+#include<utility>
+
+namespace YAML {
+    class Node;
+}
+
+struct SpawnEntry {
+    TypeID typeID;
+    double weight = 1;
+    std::pair<int, int> depth{ 1, INT_MAX };     // inclusive
+    tl::optional<std::pair<int, int>> count;    // inclusive, only for stackable items
+};
+
+//////////////////////////////////////////////////
+// Weighted choice of what to spawn on a level. The depth ranges of the entries split the
+// depths into spans where the same entries can spawn, and every span gets its alias table
+// when the table is built. A pick finds the span of its depth and is O(1) after that, no
+// matter how many entries the table has. The table isn't changed after it is built, so
+// picks may come from several threads at once without locking.
+class SpawnTable {
+public:
+    SpawnTable() = default;
+    SpawnTable(std::vector<SpawnEntry> entries, std::pair<int, int> rolls);
+
+    // how many picks to make on one level
+    int rollCount(LevelRandom & random) const;
+
+    // returns nullptr if nothing can spawn at this depth
+    SpawnEntry const * pick(int depth, LevelRandom & random) const;
+
+    std::vector<SpawnEntry> const & getEntries() const { return entries; }
+
+private:
+    struct DepthTable {
+        int firstDepth;           // the table holds up to the firstDepth of the next one
+        std::vector<int> entries; // indices into SpawnTable::entries
+        AliasTable weights;
+    };
+
+    void buildDepthTables();
+
+    std::vector<SpawnEntry> entries;
+    std::pair<int, int> rolls{ 0, 0 };
+    std::vector<DepthTable> depthTables; // by firstDepth, the first one starts at INT_MIN
+};
+
+// Reads a table like
+//   rolls: 80..120
+//   entries:
+//     - { id: egg, weight: 5, depth: 1..10, count: 1..3 }
+// ids are resolved through `typeIDs`, depth defaults to every depth
+SpawnTable readSpawnTable(YAML::Node const & data, TypeIDTable const & typeIDs);
+
+#endif // RLRPG_SPAWN_TABLE_HPP
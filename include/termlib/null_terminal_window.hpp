@@ -0,0 +1,48 @@
+#ifndef NULL_TERMINAL_WINDOW_HPP
+#define NULL_TERMINAL_WINDOW_HPP
+
+#include"abstract_terminal_window.hpp"
+
+// Draws nothing and never gets input, for programs that use the game without a terminal
+class NullTerminalWindow : public AbstractTerminalWindow {
+public:
+    explicit NullTerminalWindow(Size2i size = Size2i{ 80, 24 }): size(size) {}
+
+    void setCursorPosition(Coord2i position) override {
+        cursor = position;
+    }
+
+    Coord2i getCursorPosition() const override {
+        return cursor;
+    }
+
+    void put(char) override {
+        ++cursor.x;
+    }
+
+    void display() override {}
+
+    tl::optional<char> getChar(int = -1) override {
+        return {};
+    }
+
+    void setTextStyle(TextStyle) override {}
+
+    void setEchoing(bool echo) override {
+        echoing = echo;
+    }
+
+    Size2i getSize() const override {
+        return size;
+    }
+
+    void clear(Color = Color::Black) override {
+        cursor = Coord2i{};
+    }
+
+private:
+    Size2i size;
+    Coord2i cursor;
+};
+
+#endif // NULL_TERMINAL_WINDOW_HPP
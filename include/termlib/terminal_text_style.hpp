@@ -43,6 +43,10 @@ struct TextStyle {
         return optcolor.value_or(TerminalColor{});
     }
 
+    bool hasColor() const {
+        return optcolor.has_value();
+    }
+
 private:
     tl::optional<TerminalColor> optcolor;
 };
@@ -0,0 +1,58 @@
+#ifndef RLRPG_TILE_TYPES_HPP
+#define RLRPG_TILE_TYPES_HPP
+
+#include<render_data.hpp>
+
+#include<array>
+#include<cstdint>
+#include<string>
+
+// a level cell, the id of its tile type
+using Tile = std::uint8_t;
+
+namespace tile {
+    // the level generators carve levels out of these two, data/tiles.yaml has to define them
+    Tile const FLOOR = 1;
+    Tile const WALL = 2;
+}
+
+struct TileType {
+    std::string name;
+    PackedCell symbol{ ' ' };
+    bool walkable = false;
+    bool opaque = false;
+    bool diggable = false; // into floor
+};
+
+//////////////////////////////////////////////////
+// Tile types by id, read from data/tiles.yaml. The properties checked on every step of
+// the movement and sight code are packed into one byte per id, so such a check is a single
+// load from a 256-byte table, whatever tiles the data defines.
+class TileTypes {
+public:
+    static int const COUNT = 256;
+
+    // throws if the id is taken
+    void add(Tile tile, TileType type);
+
+    bool isDefined(Tile tile) const { return flags[tile] & Defined; }
+    bool isWalkable(Tile tile) const { return flags[tile] & Walkable; }
+    bool isOpaque(Tile tile) const { return flags[tile] & Opaque; }
+    bool isDiggable(Tile tile) const { return flags[tile] & Diggable; }
+
+    // throws if the tile isn't defined
+    TileType const & at(Tile tile) const;
+
+private:
+    enum Flags : std::uint8_t {
+        Defined = 1 << 0,
+        Walkable = 1 << 1,
+        Opaque = 1 << 2,
+        Diggable = 1 << 3
+    };
+
+    std::array<std::uint8_t, COUNT> flags{};
+    std::array<TileType, COUNT> types;
+};
+
+#endif // RLRPG_TILE_TYPES_HPP
@@ -0,0 +1,51 @@
+#ifndef RLRPG_TYPE_ID_HPP
+#define RLRPG_TYPE_ID_HPP
+
+#include<string>
+#include<string_view>
+#include<vector>
+#include<unordered_map>
+#include<functional>
+
+//////////////////////////////////////////////////
+// Dense integer handle of an item or unit type. String ids are only
+// used while loading data and for display, everything else compares these.
+struct TypeID {
+    int value = -1;
+
+    bool isValid() const { return value >= 0; }
+
+    bool operator ==(TypeID other) const { return value == other.value; }
+    bool operator !=(TypeID other) const { return value != other.value; }
+};
+
+namespace std {
+    template<>
+    struct hash<TypeID> {
+        std::size_t operator()(TypeID id) const {
+            return std::hash<int>{}(id.value);
+        }
+    };
+}
+
+//////////////////////////////////////////////////
+// Gives every distinct string id the next free TypeID, starting from 0
+class TypeIDTable {
+public:
+    TypeID intern(std::string_view id);
+
+    // returns invalid TypeID if the id wasn't interned
+    TypeID find(std::string_view id) const;
+
+    std::string const & getName(TypeID id) const;
+
+    int size() const { return static_cast<int>(names.size()); }
+
+    void clear();
+
+private:
+    std::unordered_map<std::string, TypeID> ids;
+    std::vector<std::string> names;
+};
+
+#endif // RLRPG_TYPE_ID_HPP
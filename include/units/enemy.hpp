@@ -7,8 +7,10 @@
 #include<tl/optional.hpp>
 
 #include<string_view>
+#include<vector>
 
 class Ammo;
+class Game;
 
 class Enemy
     : public Unit
@@ -24,17 +26,28 @@ public:
     Enemy(Enemy const &);
     Enemy & operator =(Enemy const &);
 
-    void shoot();
-    void updatePosition();
-    void dropInventory() override;
+    void shoot(Game & game);
+    void updatePosition(Game & game);
+    bool canSeeHero(Game const & game) const;
+    void dropInventory(DungeonLevel & level) override;
 
     Type getType() const override {
         return Type::Enemy;
     }
 
+protected:
+    void rebindEquipment() override;
+
 private:
-    tl::optional<Coord2i> searchForShortestPath(Coord2i to) const; // returns next cell in the path if path exists
-    void moveTo(Coord2i cell);
+    tl::optional<Coord2i> searchForShortestPath(Game const & game, Coord2i to) const; // returns next cell in the path if path exists
+    void moveTo(Game & game, Coord2i cell);
+    void updateWanderCells(Game const & game);
+    tl::optional<Coord2i> pickWanderCell(Game const & game) const;
+
+    // floor cells visible from wanderCellsOrigin, rebuilt only when the enemy moves or the level changes
+    std::vector<Coord2i> wanderCells;
+    Coord2i wanderCellsOrigin = { -1, -1 };
+    int wanderCellsRevision = -1;
 };
 
 #endif // ENEMY_HPP
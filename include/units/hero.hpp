@@ -12,7 +12,10 @@
 
 #include<functional>
 
-using Random = effolkronium::random_static;
+class Game;
+class GameData;
+
+using Random = effolkronium::random_thread_local;
 
 class Hero
     : public Unit
@@ -33,37 +36,43 @@ public:
     bool isBurdened = false;
     bool canMoveThroughWalls = false;
 
-    void checkVisibleCells();
-    void clearRightPane() const;
-    void processInput(char inp);
+    void checkVisibleCells(Game const & game);
+    void clearRightPane(Game & game) const;
+    void processInput(Game & game, char inp);
 
     bool isInvisible() const;
-    bool isMapInInventory() const;
+    bool isMapInInventory(GameData const & data) const;
 
     int getInventoryItemsWeight() const;
 
     int getLevelUpXP() const;
-    bool tryLevelUp(); // returns true if reaches new level
+    bool tryLevelUp(Game & game); // returns true if reaches new level
 
     Type getType() const override { return Type::Hero; }
 
     template<class ... Args>
     bool seenUpdated(Args && ... args) const { return seenMap.at(std::forward<Args>(args)...); }
 
+    // true if there is a clear line between the hero and the cell, no matter how far it is.
+    // Filled only with the symmetric vision model, up to the longest enemy vision distance
+    bool isInLineOfSight(Coord2i cell) const { return lineOfSightMap[cell]; }
+
 private:
-    void attackEnemy(Coord2i cell);
-    void throwAnimated(Ptr<Item> item, Direction direction);
-    void shoot();
-    void eat();
-    void dropItems();
-    void pickUp();
-    void showInventory();
-    void reloadWeapon();
-    void readScroll();
-    void drinkPotion();
-    void throwItem();
-    void wieldWeapon();
-    void wearArmor();
+    void attackEnemy(Game & game, Coord2i cell);
+    void throwAnimated(Game & game, Ptr<Item> item, Direction direction);
+    void shoot(Game & game);
+    void eat(Game & game);
+    void dropItems(Game & game);
+    void pickUp(Game & game);
+    void showInventory(Game & game);
+    void reloadWeapon(Game & game);
+    void readScroll(Game & game);
+    void drinkPotion(Game & game);
+    void descend(Game & game);
+    void ascend(Game & game);
+    void throwItem(Game & game);
+    void wieldWeapon(Game & game);
+    void wearArmor(Game & game);
 
     enum SelectStatus {
         NothingToSelect,
@@ -72,22 +81,25 @@ private:
     };
 
     std::pair<SelectStatus, char> selectOneFromInventory(
+            Game & game,
             std::string_view title,
             std::function<bool(Item const &)> filter = [] (Item const &) { return true; }) const;
 
-    std::pair<SelectStatus, int> selectOneFromList(std::string_view title, std::vector<Item const *> const & items) const;
+    std::pair<SelectStatus, int> selectOneFromList(Game & game, std::string_view title, std::vector<Item const *> const & items) const;
 
     std::pair<SelectStatus, std::vector<char>> selectMultipleFromInventory(
+            Game & game,
             std::string_view title,
             std::function<bool(Item const &)> filter = [] (Item const &) { return true; }) const;
 
-    std::pair<SelectStatus, std::vector<int>> selectMultipleFromList(std::string_view title, std::vector<Item const *> const & items) const;
+    std::pair<SelectStatus, std::vector<int>> selectMultipleFromList(Game & game, std::string_view title, std::vector<Item const *> const & items) const;
 
-    void moveTo(Coord2i cell);
+    void moveTo(Game & game, Coord2i cell);
 
-    void levelUp();
+    void levelUp(Game & game);
 
     Array2D<bool, LEVEL_ROWS, LEVEL_COLS> seenMap;
+    Array2D<bool, LEVEL_ROWS, LEVEL_COLS> lineOfSightMap;
 };
 
 #endif // HERO_HPP
@@ -2,17 +2,21 @@
 #define UNIT_HPP
 
 #include<inventory.hpp>
+#include<type_id.hpp>
+#include<object_pool.hpp>
+
+#include<level.hpp>
 
 #include<termlib/vec2.hpp>
 
 #include<string>
 
 #define DELAY 0.07
-#define ENEMIESCOUNT 17
 #define AMMO_SLOT 53
 
 class Armor;
 class Weapon;
+class DungeonLevel;
 
 class Unit {
 public:
@@ -24,12 +28,17 @@ public:
     Unit() = default;
     Unit(Unit const &);
     Unit & operator=(Unit const &);
+    virtual ~Unit() = default;
+
+    // units are spawned and dropped with every level, like items they live in pool::
+    static void * operator new(std::size_t size) { return pool::allocate(size); }
+    static void operator delete(void * ptr, std::size_t size) { pool::deallocate(ptr, size); }
 
     Inventory inventory;
     Weapon* weapon = nullptr;
     Armor* armor = nullptr;
 
-    std::string id;
+    TypeID typeID;
     std::string name;
     Coord2i pos = {-1, -1};
     int health;
@@ -37,19 +46,26 @@ public:
     int vision;
 
     std::string getName();
-    bool canSee(Coord2i cell) const;
-    void setTo(Coord2i cell);
+    bool canSee(DungeonLevel const & level, Coord2i cell) const;
+    // moves the unit on `level`, its level, if the cell is free
+    void setTo(DungeonLevel & level, Coord2i cell);
     void heal(int hp);
     void dealDamage(int damage);
 
     virtual Type getType() const = 0;
-    virtual void dropInventory();
+    // drops everything on the cell of the unit
+    virtual void dropInventory(DungeonLevel & level);
 
-protected:
-    bool linearVisibilityCheck(Vec2d from, Vec2d to) const;
+    // Copies of a unit share the items of their inventories until one of them changes its own.
+    // Call before changing the inventory, so the equipment pointers follow the cloned items
+    void detachInventory();
 
+protected:
     virtual void takeArmorOff();
     virtual void unequipWeapon();
+
+    // points the equipment at the items with the same symbols in the (just detached) inventory
+    virtual void rebindEquipment();
 };
 
 #endif // UNIT_HPP
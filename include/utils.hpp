@@ -3,6 +3,11 @@
 
 #include<termlib/vec2.hpp>
 
+#include<tl/optional.hpp>
+
+#include<string>
+#include<utility>
+
 template<class T>
 inline int sgn(T x) {
     if (x > 0)
@@ -33,6 +38,9 @@ inline auto clamp(T min, U val, V max) {
 
 void sleep(double sec);
 
+// Parses "a..b" into [a, b] and a single number "a" into [a, a]
+tl::optional<std::pair<int, int>> parseRange(std::string const & toParse);
+
 template<class T>
 T distSquared(Vec2<T> const & point1, Vec2<T> const & point2) {
     return sqr(point1 - point2);
@@ -12,6 +12,7 @@
 #include<memory>
 
 class YAMLFileCache;
+class GameData;
 class Food;
 class Armor;
 class Ammo;
@@ -28,9 +29,11 @@ class YAMLItemLoader : public AbstractItemLoader {
     Ptr<Potion> loadPotion(std::string_view id);
 
     YAMLFileCache & yamlFileCache;
+    GameData & data;
 
 public:
-    explicit YAMLItemLoader(YAMLFileCache & cache): yamlFileCache(cache) {}
+    // fills the item registries of `data`
+    YAMLItemLoader(YAMLFileCache & cache, GameData & data): yamlFileCache(cache), data(data) {}
 
     void load() override;
 };
@@ -11,17 +11,20 @@
 #include<string_view>
 
 class YAMLFileCache;
+class GameData;
 class Hero;
 class Enemy;
 
 class YAMLUnitLoader : public AbstractUnitLoader {
     YAMLFileCache & yamlFileCache;
+    GameData & data;
 
     Ptr<Hero> loadHero();
     Ptr<Enemy> loadEnemy(std::string const & id);
 
 public:
-    explicit YAMLUnitLoader(YAMLFileCache & cache): yamlFileCache(cache) {}
+    // fills the hero template and the enemy types of `data`, its items have to be loaded
+    YAMLUnitLoader(YAMLFileCache & cache, GameData & data): yamlFileCache(cache), data(data) {}
 
     void load() override;
 };
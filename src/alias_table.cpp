@@ -0,0 +1,61 @@
+#include<alias_table.hpp>
+
+#include<numeric>
+#include<algorithm>
+#include<stdexcept>
+
+AliasTable::AliasTable(std::vector<double> const & weights) {
+    double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    if (total <= 0)
+        return;
+
+    int n = static_cast<int>(weights.size());
+    probability.resize(n);
+    alias.resize(n);
+
+    // scale weights so the average column is exactly 1
+    std::vector<double> scaled(n);
+    std::vector<int> small, large;
+    for (int i = 0; i < n; ++i) {
+        if (weights[i] < 0)
+            throw std::logic_error("Alias table weights must be non-negative");
+        scaled[i] = weights[i] * n / total;
+        (scaled[i] < 1 ? small : large).push_back(i);
+    }
+
+    // fill every underfull column with the excess of an overfull one
+    while (not small.empty() and not large.empty()) {
+        int less = small.back();
+        small.pop_back();
+        int more = large.back();
+
+        probability[less] = scaled[less];
+        alias[less] = more;
+
+        scaled[more] -= 1 - scaled[less];
+        if (scaled[more] < 1) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    // what is left is full up to rounding errors, but a zero weight must still never be picked
+    int anyPositive = static_cast<int>(std::find_if(weights.begin(), weights.end(), [] (double weight) {
+        return weight > 0;
+    }) - weights.begin());
+    for (auto const * rest : { &large, &small }) {
+        for (int i : *rest) {
+            probability[i] = weights[i] > 0 ? 1 : 0;
+            alias[i] = anyPositive;
+        }
+    }
+}
+
+int AliasTable::pick(LevelRandom & random) const {
+    if (empty())
+        return -1;
+    // one uniform draw gives both the column and the position inside it
+    double position = random.real() * size();
+    int column = std::min(static_cast<int>(position), size() - 1);
+    return position - column < probability[column] ? column : alias[column];
+}
@@ -0,0 +1,89 @@
+#include<dungeon_level.hpp>
+
+#include<items/item.hpp>
+#include<units/unit.hpp>
+
+#include<stdexcept>
+#include<algorithm>
+#include<cstdlib>
+
+DungeonLevel::DungeonLevel(TileTypes const & tileTypes): tileTypes(tileTypes) {}
+DungeonLevel::~DungeonLevel() = default;
+
+void DungeonLevel::drop(Ptr<Item> item, Coord2i cell) {
+    if (tileTypes.isOpaque(tiles[cell]))
+        throw std::logic_error("Trying to drop an item into an opaque tile");
+    if (not item)
+        return;
+    item->pos = cell;
+    if (item->isStackable()) {
+        if (auto found = findItemAt(cell, item->getTypeID())) {
+            found->count += item->count;
+            return;
+        }
+    }
+    items.add(cell, std::move(item));
+}
+
+Coord2i DungeonLevel::findFreeCellNear(Coord2i cell) const {
+    int const maxRadius = std::max(LEVEL_ROWS, LEVEL_COLS);
+    for (int radius = 0; radius < maxRadius; ++radius) {
+        for (int y = cell.y - radius; y <= cell.y + radius; ++y) {
+            for (int x = cell.x - radius; x <= cell.x + radius; ++x) {
+                Coord2i near{ x, y };
+                bool onRing = std::abs(x - cell.x) == radius or std::abs(y - cell.y) == radius;
+                if (onRing and tiles.isIndex(near) and freeCells.contains(near))
+                    return near;
+            }
+        }
+    }
+    throw std::logic_error("There is no free cell on the level");
+}
+
+void DungeonLevel::setTile(Coord2i cell, Tile tile) {
+    tiles[cell] = tile;
+    if (tileTypes.isWalkable(tile) and not units[cell])
+        freeCells.add(cell);
+    else
+        freeCells.remove(cell);
+}
+
+void DungeonLevel::placeUnit(Ptr<Unit> unit, Coord2i cell) {
+    if (not freeCells.contains(cell))
+        throw std::logic_error("Trying to place a unit on a cell that isn't free");
+    unit->pos = cell;
+    units[cell] = std::move(unit);
+    freeCells.remove(cell);
+}
+
+Ptr<Unit> DungeonLevel::removeUnit(Coord2i cell) {
+    auto unit = std::move(units[cell]);
+    if (tileTypes.isWalkable(tiles[cell]))
+        freeCells.add(cell);
+    return unit;
+}
+
+void DungeonLevel::moveUnit(Coord2i from, Coord2i to) {
+    if (not freeCells.contains(to))
+        throw std::logic_error("Trying to move a unit to a cell that isn't free");
+    placeUnit(removeUnit(from), to);
+}
+
+void DungeonLevel::indexFreeCells() {
+    freeCells.clear();
+    freeCells.reserve(LEVEL_ROWS * LEVEL_COLS);
+    for (int r = 0; r < LEVEL_ROWS; ++r) {
+        for (int c = 0; c < LEVEL_COLS; ++c) {
+            Coord2i cell{ c, r };
+            if (tileTypes.isWalkable(tiles[cell]) and not units[cell])
+                freeCells.add(cell);
+        }
+    }
+}
+
+Item * DungeonLevel::findItemAt(Coord2i cell, TypeID typeID) {
+    for (auto const & item : items[cell])
+        if (item->getTypeID() == typeID)
+            return item.get();
+    return nullptr;
+}
@@ -7,26 +7,24 @@
 #include<direction.hpp>
 #include<units/hero.hpp>
 #include<game.hpp>
+#include<line_of_sight.hpp>
+#include<fov_table.hpp>
 
 #include<effolkronium/random.hpp>
 
 #include<fmt/format.h>
 
 #include<queue>
+#include<algorithm>
 
-using Random = effolkronium::random_static;
+using Random = effolkronium::random_thread_local;
 
 Enemy::Enemy(Enemy const & other)
     : Unit(other)
+    , ammo(other.ammo)
     , target(other.target)
     , lastTurnMoved(other.lastTurnMoved)
-    , xpCost(other.xpCost) {
-    if (other.ammo == nullptr) {
-        ammo = nullptr;
-    } else {
-        ammo = dynamic_cast<Ammo *>(&inventory[other.ammo->inventorySymbol]);
-    }
-}
+    , xpCost(other.xpCost) {}
 
 Enemy & Enemy::operator =(Enemy const & other) {
     if (this == &other) {
@@ -36,52 +34,50 @@ Enemy & Enemy::operator =(Enemy const & other) {
     target = other.target;
     lastTurnMoved = other.lastTurnMoved;
     xpCost = other.xpCost;
-    if (other.ammo == nullptr) {
-        ammo = nullptr;
-    } else {
-        ammo = dynamic_cast<Ammo *>(&inventory[other.ammo->inventorySymbol]);
-    }
+    ammo = other.ammo;
     return *this;
 }
 
-void Enemy::dropInventory() {
+void Enemy::rebindEquipment() {
+    Unit::rebindEquipment();
+    if (ammo != nullptr) {
+        ammo = dynamic_cast<Ammo *>(&inventory[ammo->inventorySymbol]);
+    }
+}
+
+void Enemy::dropInventory(DungeonLevel & level) {
     ammo = nullptr;
-    Unit::dropInventory();
+    Unit::dropInventory(level);
 }
 
-void Enemy::shoot() {
+void Enemy::shoot(Game & game) {
     if (weapon == nullptr or ammo == nullptr)
         return;
 
-    auto dir = directionFrom(g_game.getHero().pos - pos).value();
+    auto dir = directionFrom(game.getHero().pos - pos).value();
     Vec2i offset = toVec2i(dir);
     char sym = toChar(dir);
-    for (int i = 1; i < weapon->range + ammo->range; i++) {
-        Coord2i cell = pos + offset * i;
-
-        if (g_game.level()[cell] == 2)
-            break;
-
-        auto const & unitsMap = g_game.getUnitsMap();
+    auto const & level = game.getCurrentLevel();
+    los::traceProjectile(level.tiles, level.tileTypes, pos, offset, weapon->range + ammo->range, [&] (Coord2i cell, int) {
+        auto const & unitsMap = game.getUnitsMap();
         if (unitsMap[cell] and unitsMap[cell]->getType() == Unit::Type::Hero) {
-            g_game.getHero().dealDamage(ammo->damage + weapon->damageBonus);
-            break;
+            game.getHero().dealDamage(ammo->damage + weapon->damageBonus);
+            return false;
         }
-        g_game.getRenderer()
+        game.getRenderer()
             .setCursorPosition(cell)
             .put(sym)
             .display();
-        sleep(DELAY / 3);
-    }
+        game.pauseAnimation(DELAY / 3);
+        return true;
+    });
 
-    ammo->count--;
-    if (ammo->count <= 0) {
-        inventory.remove(ammo->inventorySymbol);
+    detachInventory();
+    if (not inventory.consume(ammo->inventorySymbol))
         ammo = nullptr;
-    }
 }
 
-tl::optional<Coord2i> Enemy::searchForShortestPath(Coord2i to) const {
+tl::optional<Coord2i> Enemy::searchForShortestPath(Game const & game, Coord2i to) const {
     if (to == pos)
         return {};
 
@@ -99,7 +95,7 @@ tl::optional<Coord2i> Enemy::searchForShortestPath(Coord2i to) const {
         toVec2i(Direction::Right),
         toVec2i(Direction::Left)
     };
-    if (g_game.getMode() == 2) {
+    if (game.getMode() == 2) {
         dirs.push_back(toVec2i(Direction::UpRight));
         dirs.push_back(toVec2i(Direction::UpLeft));
         dirs.push_back(toVec2i(Direction::DownRight));
@@ -118,10 +114,10 @@ tl::optional<Coord2i> Enemy::searchForShortestPath(Coord2i to) const {
 
         for (auto dir : dirs) {
             auto tv = v + dir;
-            auto const & unitsMap = g_game.getUnitsMap();
+            auto const & unitsMap = game.getUnitsMap();
             if (unitsMap.isIndex(tv)
                     and (not unitsMap[tv] or unitsMap[tv]->getType() == Unit::Type::Hero)
-                    and g_game.level()[tv] != 2 and used[tv] == 0) {
+                    and game.getData().getTileTypes().isWalkable(game.level()[tv]) and used[tv] == 0) {
                 q.push(tv);
                 used[tv] = 1 + used[v];
             }
@@ -145,20 +141,20 @@ tl::optional<Coord2i> Enemy::searchForShortestPath(Coord2i to) const {
     return v;
 }
 
-void Enemy::moveTo(Coord2i cell) {
-    if (g_game.level()[cell] == 2)
-        throw std::logic_error("Trying to move an enemy into a wall");
+void Enemy::moveTo(Game & game, Coord2i cell) {
+    if (not game.getData().getTileTypes().isWalkable(game.level()[cell]))
+        throw std::logic_error("Trying to move an enemy onto a tile that isn't walkable");
 
-    auto const & unitsMap = g_game.getUnitsMap();
+    auto const & unitsMap = game.getUnitsMap();
     if (not unitsMap[cell]) {
-        setTo(cell);
+        setTo(game.getCurrentLevel(), cell);
         return;
     }
 
     if (unitsMap[cell]->getType() == Unit::Type::Enemy or weapon == nullptr)
         return;
 
-    auto & hero = g_game.getHero();
+    auto & hero = game.getHero();
     if (hero.armor == nullptr or hero.armor->mdf != 2) {
         hero.dealDamage(weapon->damage);
     } else {
@@ -166,53 +162,80 @@ void Enemy::moveTo(Coord2i cell) {
     }
 
     if (health <= 0) {
-        g_game.getUnitsMap()[pos].reset();
+        game.getCurrentLevel().removeUnit(pos);
         return;
     }
 }
 
-void Enemy::updatePosition() {
-    lastTurnMoved = g_game.getTurnNumber();
-    auto const & hero = g_game.getHero();
+void Enemy::updatePosition(Game & game) {
+    lastTurnMoved = game.getTurnNumber();
+    auto const & hero = game.getHero();
 
-    if (not hero.isInvisible() and canSee(hero.pos)) {
+    if (not hero.isInvisible() and canSeeHero(game)) {
         bool onDiagLine = std::abs(hero.pos.y - pos.y) == std::abs(hero.pos.x - pos.x);
         bool canShootHero = (pos.y == hero.pos.y or pos.x == hero.pos.x or onDiagLine)
                 and weapon and weapon->isRanged and ammo
                 and weapon->range + ammo->range >= std::abs(hero.pos.y - pos.y) + std::abs(hero.pos.x - pos.x);
         if (canShootHero) {
-            shoot();
+            shoot(game);
         } else {
             target = hero.pos;
 
-            if (auto next = searchForShortestPath(hero.pos)) {
-                moveTo(*next);
+            if (auto next = searchForShortestPath(game, hero.pos)) {
+                moveTo(game, *next);
                 return;
             }
         }
     }
     tl::optional<Coord2i> next;
-    if (target.has_value() and (next = searchForShortestPath(*target))) {
-        moveTo(*next);
+    if (target.has_value() and (next = searchForShortestPath(game, *target))) {
+        moveTo(game, *next);
         return;
     }
 
-    std::vector<Coord2i> visibleCells;
-
-    g_game.getUnitsMap().forEach([&] (Coord2i cell, Ptr<Unit> const & unit) {
-        if (cell != pos and g_game.level()[cell] != 2 and not unit and canSee(cell)) {
-            visibleCells.push_back(cell);
-        }
-    });
+    updateWanderCells(game);
 
     int attempts = 15;
     for (int i = 0; i < attempts; ++i) {
-        target = *Random::get(visibleCells);
+        target = pickWanderCell(game);
+        if (not target)
+            continue;
 
-        if (auto next = searchForShortestPath(*target)) {
-            moveTo(*next);
+        if (auto next = searchForShortestPath(game, *target)) {
+            moveTo(game, *next);
             return;
         }
     }
 }
 
+bool Enemy::canSeeHero(Game const & game) const {
+    auto const & hero = game.getHero();
+    if (game.getVisionModel() == VisionModel::Symmetric)
+        return distSquared(pos, hero.pos) < sqr(vision) and hero.isInLineOfSight(pos);
+    return canSee(game.getCurrentLevel(), hero.pos);
+}
+
+void Enemy::updateWanderCells(Game const & game) {
+    if (wanderCellsOrigin == pos and wanderCellsRevision == game.getLevelRevision())
+        return;
+
+    wanderCells.clear();
+    wanderCellsOrigin = pos;
+    wanderCellsRevision = game.getLevelRevision();
+
+    auto const & level = game.getCurrentLevel();
+    fov::forEachVisibleCell(level.tiles, level.tileTypes, pos, vision, [this, &level] (Coord2i cell) {
+        if (cell != pos and level.tileTypes.isWalkable(level.tiles[cell]))
+            wanderCells.push_back(cell);
+    });
+}
+
+tl::optional<Coord2i> Enemy::pickWanderCell(Game const & game) const {
+    if (wanderCells.empty())
+        return {};
+
+    Coord2i cell = *Random::get(wanderCells);
+    if (game.getUnitsMap()[cell])
+        return {};
+    return cell;
+}
@@ -0,0 +1,317 @@
+#include<floor_archive.hpp>
+
+#include<game_data.hpp>
+#include<tile_types.hpp>
+#include<items/item.hpp>
+#include<items/ammo.hpp>
+#include<items/armor.hpp>
+#include<items/weapon.hpp>
+#include<units/enemy.hpp>
+
+#include<stdexcept>
+
+namespace {
+    // LEB128 integers: 7 bits per byte, the high bit tells that more bytes follow
+    class ByteWriter {
+    public:
+        explicit ByteWriter(std::vector<std::uint8_t> & bytes): bytes(bytes) {}
+
+        void write(std::uint64_t value) {
+            while (value >= 0x80) {
+                bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        // zigzag, so small negative numbers stay short
+        void writeSigned(std::int64_t value) {
+            write((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+        }
+
+        void writeCell(Coord2i cell) {
+            write(cell.y * LEVEL_COLS + cell.x);
+        }
+
+    private:
+        std::vector<std::uint8_t> & bytes;
+    };
+
+    class ByteReader {
+    public:
+        explicit ByteReader(std::vector<std::uint8_t> const & bytes): bytes(bytes) {}
+
+        std::uint64_t read() {
+            std::uint64_t value = 0;
+            for (int shift = 0; ; shift += 7) {
+                if (pos == bytes.size() or shift > 63)
+                    throw std::logic_error("Packed floor is corrupted");
+                std::uint8_t byte = bytes[pos++];
+                value |= std::uint64_t(byte & 0x7F) << shift;
+                if (not (byte & 0x80))
+                    return value;
+            }
+        }
+
+        int readInt() {
+            return static_cast<int>(read());
+        }
+
+        int readSigned() {
+            std::uint64_t value = read();
+            return static_cast<int>(static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1));
+        }
+
+        Coord2i readCell() {
+            int index = readInt();
+            if (index >= LEVEL_ROWS * LEVEL_COLS)
+                throw std::logic_error("Packed floor is corrupted");
+            return Coord2i{ index % LEVEL_COLS, index / LEVEL_COLS };
+        }
+
+        bool atEnd() const { return pos == bytes.size(); }
+
+    private:
+        std::vector<std::uint8_t> const & bytes;
+        std::size_t pos = 0;
+    };
+
+    enum ItemFlags {
+        ShowMdf = 1 << 0,
+        HasMdf = 1 << 1,
+        HasCount = 1 << 2
+    };
+
+    void writeItem(ByteWriter & out, Item const & item) {
+        out.write(item.getTypeID().value);
+        int flags = (item.showMdf ? ShowMdf : 0) | (item.mdf != 1 ? HasMdf : 0) | (item.count != 1 ? HasCount : 0);
+        out.write(flags);
+        if (flags & HasMdf)
+            out.writeSigned(item.mdf);
+        if (flags & HasCount)
+            out.write(item.count);
+
+        if (item.getType() == Item::Type::Weapon) {
+            auto const & cartridge = static_cast<Weapon const &>(item).cartridge;
+            out.write(cartridge.end() - cartridge.begin());
+            for (auto const & run : cartridge) {
+                out.write(run.ammo->getTypeID().value);
+                out.write(run.count);
+            }
+        }
+    }
+
+    Ptr<Item> readItem(ByteReader & in, GameData const & data) {
+        TypeID typeID{ in.readInt() };
+        auto item = data.createItem(typeID);
+        if (not item)
+            throw std::logic_error("Unknown item type in a packed floor");
+
+        int flags = in.readInt();
+        item->showMdf = flags & ShowMdf;
+        item->mdf = flags & HasMdf ? in.readSigned() : 1;
+        item->count = flags & HasCount ? in.readInt() : 1;
+
+        if (item->getType() == Item::Type::Weapon) {
+            auto & cartridge = static_cast<Weapon &>(*item).cartridge;
+            cartridge = Weapon::Cartridge(cartridge.getCapacity());
+            int runs = in.readInt();
+            for (int i = 0; i < runs; ++i) {
+                TypeID ammoID{ in.readInt() };
+                int count = in.readInt();
+                cartridge.load(*data.getAmmoTypes().at(ammoID), count);
+            }
+        }
+        return item;
+    }
+
+    int const CELL_COUNT = LEVEL_ROWS * LEVEL_COLS;
+
+    // Writes `valueAt(index)` of every cell in row-major order as runs of equal values
+    template<class Fn>
+    void writeRuns(ByteWriter & out, Fn && valueAt) {
+        std::uint64_t runValue = valueAt(0);
+        int runLength = 0;
+        for (int index = 0; index < CELL_COUNT; ++index) {
+            std::uint64_t value = valueAt(index);
+            if (value != runValue) {
+                out.write(runValue);
+                out.write(runLength);
+                runValue = value;
+                runLength = 0;
+            }
+            ++runLength;
+        }
+        out.write(runValue);
+        out.write(runLength);
+    }
+
+    // Reads what writeRuns() wrote, calls `setValue(index, value)` for every cell
+    template<class Fn>
+    void readRuns(ByteReader & in, Fn && setValue) {
+        for (int index = 0; index < CELL_COUNT; ) {
+            std::uint64_t value = in.read();
+            int runLength = in.readInt();
+            if (runLength <= 0 or index + runLength > CELL_COUNT)
+                throw std::logic_error("Packed floor is corrupted");
+            for (int end = index + runLength; index < end; ++index)
+                setValue(index, value);
+        }
+    }
+
+    char symbolOf(Item const * item) {
+        return item ? item->inventorySymbol : 0;
+    }
+
+    void writeEnemy(ByteWriter & out, Enemy const & enemy) {
+        out.write(enemy.typeID.value);
+        out.writeSigned(enemy.health);
+        out.write(enemy.lastTurnMoved);
+        out.write(enemy.target ? 1 : 0);
+        if (enemy.target)
+            out.writeCell(*enemy.target);
+
+        // an inventory shared with the prototype is the prototype's one
+        if (enemy.inventory.isShared()) {
+            out.write(0);
+            return;
+        }
+        out.write(1);
+        out.write(symbolOf(enemy.weapon));
+        out.write(symbolOf(enemy.armor));
+        out.write(symbolOf(enemy.ammo));
+        out.write(enemy.inventory.size());
+        for (auto const & [symbol, item] : enemy.inventory) {
+            out.write(symbol);
+            writeItem(out, *item);
+        }
+    }
+
+    Ptr<Enemy> readEnemy(ByteReader & in, GameData const & data) {
+        auto enemy = data.getEnemyTypes().at(TypeID{ in.readInt() })->clone();
+        enemy->health = in.readSigned();
+        enemy->lastTurnMoved = in.readInt();
+        if (in.readInt())
+            enemy->target = in.readCell();
+
+        if (not in.readInt())
+            return enemy;
+
+        char weaponSymbol = static_cast<char>(in.readInt());
+        char armorSymbol = static_cast<char>(in.readInt());
+        char ammoSymbol = static_cast<char>(in.readInt());
+
+        enemy->inventory = Inventory{};
+        int itemCount = in.readInt();
+        for (int i = 0; i < itemCount; ++i) {
+            char symbol = static_cast<char>(in.readInt());
+            if (not enemy->inventory.add(readItem(in, data), symbol))
+                throw std::logic_error("Packed floor is corrupted");
+        }
+
+        auto & inventory = enemy->inventory;
+        enemy->weapon = weaponSymbol ? &dynamic_cast<Weapon &>(inventory[weaponSymbol]) : nullptr;
+        enemy->armor = armorSymbol ? &dynamic_cast<Armor &>(inventory[armorSymbol]) : nullptr;
+        enemy->ammo = ammoSymbol ? &dynamic_cast<Ammo &>(inventory[ammoSymbol]) : nullptr;
+        return enemy;
+    }
+}
+
+PackedFloor packFloor(DungeonLevel const & level) {
+    PackedFloor packed;
+    packed.depth = level.depth;
+    ByteWriter out(packed.bytes);
+
+    out.write(level.depth);
+    out.writeCell(level.entrance);
+    out.writeCell(level.stairsDown);
+
+    writeRuns(out, [&level] (int index) {
+        return level.tiles.at(index / LEVEL_COLS, index % LEVEL_COLS);
+    });
+    // mostly empty cells and runs of walls
+    writeRuns(out, [&level] (int index) {
+        return level.remembered.at(index / LEVEL_COLS, index % LEVEL_COLS).toBits();
+    });
+
+    // piles in cell order rather than the hash map's, so equal floors pack into equal bytes
+    int pileCount = 0;
+    level.items.forEach([&] (Coord2i, ItemPile const &) {
+        ++pileCount;
+    });
+    out.write(pileCount);
+    for (int r = 0; r < LEVEL_ROWS; ++r) {
+        for (int c = 0; c < LEVEL_COLS; ++c) {
+            Coord2i cell{ c, r };
+            if (not level.items.hasItems(cell))
+                continue;
+            auto const & pile = level.items[cell];
+            out.writeCell(cell);
+            out.write(pile.size());
+            for (auto const & item : pile)
+                writeItem(out, *item);
+        }
+    }
+
+    int unitCount = 0;
+    level.units.forEach([&] (Ptr<Unit> const & unit) {
+        if (not unit)
+            return;
+        if (unit->getType() != Unit::Type::Enemy)
+            throw std::logic_error("Only enemies can be packed with a floor");
+        ++unitCount;
+    });
+    out.write(unitCount);
+    level.units.forEach([&] (Coord2i cell) {
+        if (auto const & unit = level.units[cell]) {
+            out.writeCell(cell);
+            writeEnemy(out, static_cast<Enemy const &>(*unit));
+        }
+    });
+
+    packed.bytes.shrink_to_fit();
+    return packed;
+}
+
+Ptr<DungeonLevel> unpackFloor(PackedFloor const & packed, GameData const & data) {
+    ByteReader in(packed.bytes);
+    auto level = std::make_unique<DungeonLevel>(data.getTileTypes());
+
+    level->depth = in.readInt();
+    level->entrance = in.readCell();
+    level->stairsDown = in.readCell();
+
+    readRuns(in, [&level] (int index, std::uint64_t tile) {
+        if (tile >= TileTypes::COUNT or not level->tileTypes.isDefined(static_cast<Tile>(tile)))
+            throw std::logic_error("Packed floor is corrupted");
+        level->tiles.at(index / LEVEL_COLS, index % LEVEL_COLS) = static_cast<Tile>(tile);
+    });
+    readRuns(in, [&level] (int index, std::uint64_t cell) {
+        if (cell > UINT32_MAX)
+            throw std::logic_error("Packed floor is corrupted");
+        level->remembered.at(index / LEVEL_COLS, index % LEVEL_COLS) = PackedCell::fromBits(static_cast<std::uint32_t>(cell));
+    });
+
+    level->indexFreeCells();
+
+    int pileCount = in.readInt();
+    for (int i = 0; i < pileCount; ++i) {
+        Coord2i cell = in.readCell();
+        int itemCount = in.readInt();
+        for (int j = 0; j < itemCount; ++j) {
+            auto item = readItem(in, data);
+            item->pos = cell;
+            level->items.add(cell, std::move(item));
+        }
+    }
+
+    int unitCount = in.readInt();
+    for (int i = 0; i < unitCount; ++i) {
+        Coord2i cell = in.readCell();
+        level->placeUnit(readEnemy(in, data), cell);
+    }
+
+    if (not in.atEnd())
+        throw std::logic_error("Packed floor is corrupted");
+    return level;
+}
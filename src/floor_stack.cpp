@@ -0,0 +1,38 @@
+#include<floor_stack.hpp>
+
+#include<effolkronium/random.hpp>
+
+using Random = effolkronium::random_thread_local;
+
+std::uint64_t FloorStack::getSeed(int depth) {
+    while (seeds.size() < depth)
+        seeds.push_back(Random::get<std::uint64_t>());
+    return seeds[depth - 1];
+}
+
+void FloorStack::store(DungeonLevel const & level) {
+    take(level.depth);
+
+    recentlyLeft.push_front(packFloor(level));
+    floors[level.depth] = recentlyLeft.begin();
+    memoryUsage += recentlyLeft.front().getSize();
+
+    while (memoryUsage > memoryBudget and recentlyLeft.size() > 1) {
+        auto const & oldest = recentlyLeft.back();
+        memoryUsage -= oldest.getSize();
+        floors.erase(oldest.getDepth());
+        recentlyLeft.pop_back();
+    }
+}
+
+tl::optional<PackedFloor> FloorStack::take(int depth) {
+    auto found = floors.find(depth);
+    if (found == floors.end())
+        return tl::nullopt;
+
+    PackedFloor packed = std::move(*found->second);
+    memoryUsage -= packed.getSize();
+    recentlyLeft.erase(found->second);
+    floors.erase(found);
+    return packed;
+}
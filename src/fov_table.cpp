@@ -0,0 +1,73 @@
+#include<fov_table.hpp>
+
+namespace {
+    constexpr fov::RayTable makeRayTable() {
+        using namespace fov;
+
+        RayTable table{};
+        for (auto & row : table.index)
+            for (auto & entry : row)
+                entry = -1;
+
+        int entryCount = 0;
+        int cellCount = 0;
+        int radius = 0;
+        // visit offsets in the order of growing distance, so entries closer than r form a prefix
+        for (int distSquared = 0; distSquared < TABLE_RADIUS * TABLE_RADIUS; ++distSquared) {
+            while (radius * radius <= distSquared)
+                table.entriesWithin[radius++] = entryCount;
+
+            for (int y = -TABLE_RADIUS; y <= TABLE_RADIUS; ++y) {
+                for (int x = -TABLE_RADIUS; x <= TABLE_RADIUS; ++x) {
+                    if (x * x + y * y != distSquared)
+                        continue;
+
+                    auto & entry = table.entries[entryCount];
+                    entry.x = x;
+                    entry.y = y;
+                    int ray = 0;
+                    detail::forEachRay(x, y, [&] (long long fromX, long long fromY, long long toX, long long toY) {
+                        entry.rays[ray++] = cellCount;
+                        los::walkRay(fromX, fromY, toX, toY, [&] (long long cellX, long long cellY) {
+                            table.cells[cellCount].x = cellX;
+                            table.cells[cellCount].y = cellY;
+                            ++cellCount;
+                            return true;
+                        });
+                    });
+                    entry.rays[RAYS_PER_CELL] = cellCount;
+                    table.index[y + TABLE_RADIUS][x + TABLE_RADIUS] = entryCount;
+                    ++entryCount;
+                }
+            }
+        }
+        while (radius <= TABLE_RADIUS)
+            table.entriesWithin[radius++] = entryCount;
+
+        return table;
+    }
+}
+
+constexpr fov::RayTable fov::rayTable = makeRayTable();
+
+bool fov::isVisible(LevelData const & level, TileTypes const & tileTypes, Coord2i from, TableEntry const & entry) {
+    for (int ray = 0; ray < RAYS_PER_CELL; ++ray) {
+        bool clear = true;
+        for (int i = entry.rays[ray]; i < entry.rays[ray + 1]; ++i) {
+            Coord2i cell = from + Vec2i{ rayTable.cells[i].x, rayTable.cells[i].y };
+            if (los::isOpaque(level, tileTypes, cell)) {
+                clear = false;
+                break;
+            }
+        }
+        if (clear)
+            return true;
+    }
+    return false;
+}
+
+bool fov::isVisible(LevelData const & level, TileTypes const & tileTypes, Coord2i from, Coord2i to) {
+    if (auto entry = findEntry(to - from))
+        return isVisible(level, tileTypes, from, *entry);
+    return los::isVisible(level, tileTypes, from, to);
+}
@@ -0,0 +1,30 @@
+#include<free_cells.hpp>
+
+FreeCells::FreeCells() {
+    places.fill(NONE);
+}
+
+void FreeCells::add(Coord2i cell) {
+    int index = toIndex(cell);
+    if (places[index] != NONE)
+        return;
+    places[index] = static_cast<std::int16_t>(cells.size());
+    cells.push_back(static_cast<std::int16_t>(index));
+}
+
+void FreeCells::remove(Coord2i cell) {
+    int index = toIndex(cell);
+    int place = places[index];
+    if (place == NONE)
+        return;
+    std::int16_t last = cells.back();
+    cells[place] = last;
+    places[last] = static_cast<std::int16_t>(place);
+    cells.pop_back();
+    places[index] = NONE;
+}
+
+void FreeCells::clear() {
+    cells.clear();
+    places.fill(NONE);
+}
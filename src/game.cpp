@@ -6,15 +6,14 @@
 #include<items/weapon.hpp>
 #include<items/potion.hpp>
 #include<items/scroll.hpp>
-#include<gen_map.hpp>
 #include<level.hpp>
 #include<units/unit.hpp>
 #include<units/hero.hpp>
 #include<units/enemy.hpp>
-#include<yaml_item_loader.hpp>
-#include<yaml_file_cache.hpp>
-#include<yaml_unit_loader.hpp>
 #include<controls.hpp>
+#include<level_file.hpp>
+#include<tile_types.hpp>
+#include<utils.hpp>
 
 #include<fmt/core.h>
 #include<fmt/printf.h>
@@ -22,18 +21,21 @@
 #include<effolkronium/random.hpp>
 
 #include<memory>
+#include<cstdint>
 #include<fstream>
-#include<sstream>
+#include<stdexcept>
+#include<utility>
 
 using namespace std::string_view_literals;
 using fmt::format;
-using Random = effolkronium::random_static;
+using Random = effolkronium::random_thread_local;
 
-Game g_game;
+Game::Game(GameData const & data, AbstractTerminalWindow & window)
+    : data(data)
+    , termRend(window)
+    , termRead(window) {}
 
-void Game::setHeroTemplate(Ptr<Hero> newHeroTemplate) {
-    heroTemplate = std::move(newHeroTemplate);
-}
+Game::~Game() = default;
 
 void Game::printMenu(std::vector<std::string_view> const & items, int active) {
     TextStyle activeItemStyle{ TextStyle::Bold, Color::Red };
@@ -92,26 +94,46 @@ void Game::mSettingsMode() {
     }
 }
 
+void Game::mSettingsVision() {
+    auto result = processMenu("Choose vision model", {
+            "Symmetric",
+            "Asymmetric"});
+
+    if (result == "Symmetric") {
+        visionModel = VisionModel::Symmetric;
+    } else if (result == "Asymmetric") {
+        visionModel = VisionModel::Asymmetric;
+    }
+}
+
 void Game::mSettingsMap() {
-    termRend
-        .clear()
-        .setCursorPosition(Coord2i{})
-        .put("Do you want to load map from file?");
-    char inpChar = termRead.readChar();
-    if (inpChar == 'y' or inpChar == 'Y') {
+    auto result = processMenu("Choose maps", {
+            "Mazes",
+            "Caves",
+            "Load the first level from file"});
+
+    if (result == "Mazes") {
+        setLevelGenerator(LevelGenerator::Maze);
+        generateMap = true;
+    } else if (result == "Caves") {
+        setLevelGenerator(LevelGenerator::Caves);
+        generateMap = true;
+    } else if (result == "Load the first level from file") {
         generateMap = false;
     }
-    termRend.clear();
 }
 
 void Game::mSettings() {
     while (true) {
         auto result = processMenu("Settings", {
                 "Mode",
-                "Maps"});
+                "Vision",
+                "Maps"}, true);
 
         if (result == "Mode") {
             mSettingsMode();
+        } else if (result == "Vision") {
+            mSettingsVision();
         } else if (result == "Maps") {
             mSettingsMap();
         } else {
@@ -173,227 +195,165 @@ void Game::run() {
     if (exiting())
         return;
 
+    start();
+    while (handleKey(termRead.readChar())) {}
+}
+
+void Game::start() {
     initialize();
 
     draw();
 
-    while (true) {
-        if (exiting())
-            return;
+    beginTurn();
+}
 
-        clearBuffers();
+bool Game::handleKey(char inp) {
+    if (exiting())
+        return false;
+    if (dead) {
+        // the key that was asked for after the death message
+        exit = true;
+        return false;
+    }
 
-        bool died = false;
+    hero->processInput(*this, inp);
+    hero->checkVisibleCells(*this);
 
-        if (hero->hunger < 1) {
-            addMessage("You died from starvation. Press any key to exit.");
-            died = true;
-        }
+    if (not skippingUpdate()) {
+        updateAI();
 
-        if (hero->health < 1) {
-            addMessage("You died. Press any key to exit.");
-            died = true;
-        }
+        increaseTurnNumber();
 
-        if (died) {
-            hero->health = 0;
-            displayMessages();
-            termRead.readChar();
-            return;
+        if (turns % 25 == 0 and turns != 0 and mode == 1) {
+            hero->heal(1);
         }
 
-        termRend.setCursorPosition(hero->pos);
-
-        char inp = termRead.readChar();
-        hero->processInput(inp);
-        hero->checkVisibleCells();
-
-        if (not skippingUpdate()) {
-            updateAI();
+        hero->hunger--;
 
-            increaseTurnNumber();
+        if (hero->turnsInvisible > 0)
+            hero->turnsInvisible--;
 
-            if (turns % 25 == 0 and turns != 0 and mode == 1) {
-                hero->heal(1);
+        if (hero->turnsBlind > 0) {
+            if (hero->turnsBlind == 1) {
+                hero->vision = Hero::DEFAULT_VISION;
             }
+            hero->turnsBlind --;
+        }
 
+        if (hero->isBurdened)
             hero->hunger--;
 
-            if (hero->turnsInvisible > 0)
-                hero->turnsInvisible--;
-
-            if (hero->turnsBlind > 0) {
-                if (hero->turnsBlind == 1) {
-                    hero->vision = Hero::DEFAULT_VISION;
-                }
-                hero->turnsBlind --;
+        draw();
+
+        if (inp == '\033') {
+            termRend
+                .setCursorPosition(Coord2i{ 0, LEVEL_ROWS })
+                .put("Are you sure you want to exit?\n")
+                .display();
+            char confirmExit = termRead.readChar();
+            if (confirmExit == 'y' or confirmExit == 'Y' or confirmExit == CONTROL_CONFIRM) {
+                exit = true;
+                return false;
             }
-
-            if (hero->isBurdened)
-                hero->hunger--;
-
-            draw();
-
-            if (inp == '\033') {
-                termRend
-                    .setCursorPosition(Coord2i{ 0, LEVEL_ROWS })
-                    .put("Are you sure you want to exit?\n")
-                    .display();
-                char confirmExit = termRead.readChar();
-                if (confirmExit == 'y' or confirmExit == 'Y' or confirmExit == CONTROL_CONFIRM) {
-                    return;
-                }
-                skipUpdate();
-            }
-
-            hero->tryLevelUp();
-
-            termRend.setCursorPosition(hero->pos);
-        } else {
-            draw();
-            skipUpdate(false);
+            skipUpdate();
         }
-    }
-}
 
-tl::optional<Color> toColor(std::string_view colorString) {
-    if (colorString == "black") {
-        return Color::Black;
-    } else if (colorString == "red") {
-        return Color::Red;
-    } else if (colorString == "green") {
-        return Color::Green;
-    } else if (colorString == "yellow") {
-        return Color::Yellow;
-    } else if (colorString == "blue") {
-        return Color::Blue;
-    } else if (colorString == "magenta") {
-        return Color::Magenta;
-    } else if (colorString == "cyan") {
-        return Color::Cyan;
-    } else if (colorString == "white") {
-        return Color::White;
-    } else {
-        return tl::nullopt;
-    }
-}
+        hero->tryLevelUp(*this);
 
-tl::optional<TextStyle> toTextStyle(YAML::Node const & colorData) {
-    TextStyle style;
-    std::istringstream iss(colorData["fg"].as<std::string>());
-    std::string fgString;
-    iss >> fgString;
-    if (fgString == "light") {
-        style += TextStyle::Bold;
-        iss >> fgString;
+        termRend.setCursorPosition(hero->pos);
+    } else {
+        draw();
+        skipUpdate(false);
     }
-    return toColor(fgString).and_then([&colorData] (Color fg) {
-        if (colorData["bg"]) {
-            return toColor(colorData["bg"].as<std::string>()).and_then([fg](Color bg) {
-                return tl::optional{TerminalColor{fg, bg}};
-            });
-        }
-        return tl::optional{TerminalColor{fg}};
-    }).map([&style] (TerminalColor color) {
-        return style += color;
-    });
-}
 
-tl::optional<SymbolRenderData> toSymbolRenderData(YAML::Node const & renderData) {
-    char symbol = renderData["symbol"].as<char>();
-    if (not renderData["color"])
-        return SymbolRenderData{ symbol };
-    else
-        return toTextStyle(renderData["color"]).map([symbol](TextStyle style) {
-            return SymbolRenderData{ symbol, style };
-        });
+    beginTurn();
+    return not exiting();
 }
 
-void Game::readItemRenderData(std::string const & id, YAMLFileCache & yamlFileCache) {
-    std::string filename = fmt::format("data/items/{}.yaml", id);
-    auto const & itemData = yamlFileCache[filename];
-    if (not itemData["render"])
+void Game::beginTurn() {
+    if (exiting())
         return;
 
-    toSymbolRenderData(itemData["render"]).map([this, &id] (SymbolRenderData const & data) {
-        itemRenderData.emplace(id, data);
-    });
-}
+    clearBuffers();
 
-void Game::readItemRenderData(YAMLFileCache & yamlFileCache) {
-    auto const & itemRegistry = yamlFileCache["data/items.yaml"];
-    for (auto const & typeEntry : itemRegistry) {
-        for (auto const & itemID : typeEntry.second) {
-            readItemRenderData(itemID.as<std::string>(), yamlFileCache);
-        }
+    if (hero->hunger < 1) {
+        addMessage("You died from starvation. Press any key to exit.");
+        dead = true;
     }
-}
 
-void Game::readUnitRenderData(std::string const & id, YAML::Node const & renderData) {
-    if (not renderData)
-        return;
+    if (hero->health < 1) {
+        addMessage("You died. Press any key to exit.");
+        dead = true;
+    }
 
-    toSymbolRenderData(renderData).map([this, &id] (SymbolRenderData const & data) {
-        unitRenderData.emplace(id, data);
-    });
-}
+    if (dead) {
+        hero->health = 0;
+        displayMessages();
+        return;
+    }
 
-void Game::readHeroRenderData(YAMLFileCache & yamlFileCache) {
-    YAML::Node heroData = yamlFileCache["data/units/hero.yaml"];
-    readUnitRenderData("hero", heroData["render"]);
+    termRend.setCursorPosition(hero->pos);
 }
 
-void Game::readEnemyRenderData(std::string const & id, YAMLFileCache & yamlFileCache) {
-    std::string filename = fmt::format("data/units/enemies/{}.yaml", id);
-    YAML::Node enemyData = yamlFileCache[filename];
-    readUnitRenderData(id, enemyData["render"]);
-}
+void Game::initialize() {
+    for (auto const &[id, _] : data.getPotionTypes())
+        potionTypeKnown[id] = false;
 
-void Game::readUnitRenderData(YAMLFileCache & yamlFileCache) {
-    readHeroRenderData(yamlFileCache);
+    setRandomPotionEffects();
 
-    auto const & enemyRegistry = yamlFileCache["data/units/enemies.yaml"];
-    for (auto const & id : enemyRegistry) {
-        readEnemyRenderData(id.as<std::string>(), yamlFileCache);
+    Ptr<Unit> heroUnit = data.getHeroTemplate().clone();
+    hero = static_cast<Hero *>(heroUnit.get());
+    // the hero changes the inventory all the time, no point sharing it with the template
+    hero->detachInventory();
+
+    Ptr<DungeonLevel> level;
+    if (not needGenerateMap()) {
+        // a missing or broken map.lvl shouldn't end the game, the level is generated instead
+        try {
+            level = levelFactory.build(LevelFile{ "map.lvl", data.getTileTypes() }, 1, hero->luck, floors.getSeed(1));
+        } catch (std::exception const & e) {
+            addMessage(format("{}. The level is generated instead.", e.what()));
+        }
     }
-}
-
-void Game::loadData() {
-    YAMLFileCache yamlFileCache;
-    std::unique_ptr<AbstractItemLoader> itemLoader(new YAMLItemLoader(yamlFileCache));
-    itemLoader->load();
-
-    readItemRenderData(yamlFileCache);
+    if (not level)
+        level = levelFactory.build(1, hero->luck, floors.getSeed(1));
+    Coord2i entrance = level->entrance;
+    enterLevel(std::move(level), std::move(heroUnit), entrance);
 
-    std::unique_ptr<AbstractUnitLoader> unitLoader(new YAMLUnitLoader(yamlFileCache));
-    unitLoader->load();
-
-    readUnitRenderData(yamlFileCache);
+    hero->checkVisibleCells(*this);
 }
 
-void Game::initialize() {
-    initField();
-
-    if (needGenerateMap())
-        generateMaze();
-    else
-        readMap();
-
-    loadData();
+void Game::enterLevel(Ptr<DungeonLevel> level, Ptr<Unit> heroUnit, Coord2i arrival) {
+    currLevel = std::move(level);
+    currLevel->placeUnit(std::move(heroUnit), currLevel->findFreeCellNear(arrival));
+    markLevelChanged();
 
-    for (auto const &[id, _] : potionTypes)
-        potionTypeKnown[id] = false;
+    int nextDepth = currLevel->depth + 1;
+    if (not floors.contains(nextDepth))
+        levelFactory.prepare(nextDepth, hero->luck, floors.getSeed(nextDepth));
+}
 
-    setRandomPotionEffects();
+void Game::changeFloor(int depth) {
+    bool down = depth > getDepth();
+    auto heroUnit = currLevel->removeUnit(hero->pos);
+    floors.store(*currLevel);
+    levelFactory.retire(std::move(currLevel));
 
-    spawnUnits();
-    setItems();
+    Ptr<DungeonLevel> level;
+    if (auto packed = floors.take(depth)) {
+        level = levelFactory.restore(std::move(*packed));
+    } else {
+        levelFactory.prepare(depth, hero->luck, floors.getSeed(depth));
+        level = levelFactory.take();
+    }
 
-    hero->checkVisibleCells();
+    Coord2i arrival = down ? level->entrance : level->stairsDown;
+    enterLevel(std::move(level), std::move(heroUnit), arrival);
+    addMessage(format("You go {} to the level {}.", down ? "down" : "up", getDepth()));
 }
 
 void Game::updateAI() {
-    unitsMap.forEach([&] (Ptr<Unit> & unit) {
+    currLevel->units.forEach([&] (Ptr<Unit> & unit) {
         if (not unit or unit->getType() != Unit::Type::Enemy)
             return;
 
@@ -403,55 +363,10 @@ void Game::updateAI() {
         if (mode == 2 and turns % 200 == 0) {
             enemy.heal(1);
         }
-        enemy.updatePosition();
+        enemy.updatePosition(*this);
     });
 }
 
-void Game::setItems() {
-    randomlySelectAndSetOnMap(foodTypes, Food::COUNT);
-    randomlySelectAndSetOnMap(armorTypes, Armor::COUNT, [this] (Registry<Ptr<Armor>> const & types) {
-        auto item = Random::get(types)->second->clone();
-        float thornsProbability = hero->luck / 500.f;
-        if (Random::get<bool>(thornsProbability)) {
-            item->mdf = 2;
-        }
-        return item;
-    });
-    randomlySelectAndSetOnMap(weaponTypes, Weapon::COUNT);
-    randomlySelectAndSetOnMap(ammoTypes, Ammo::COUNT, [this] (Registry<Ptr<Ammo>> const & types) {
-        auto ammo = Random::get(types)->second->clone();
-        ammo->count = Random::get(1, hero->luck);
-        return ammo;
-    });
-    randomlySelectAndSetOnMap(scrollTypes, Scroll::COUNT);
-    randomlySelectAndSetOnMap(potionTypes, Potion::COUNT);
-}
-
-void Game::spawnUnits() {
-    for (int i = 0; i < 1; i++) {
-        Coord2i pos{ Random::get(0, LEVEL_COLS - 1), Random::get(0, LEVEL_ROWS - 1) };
-        if (levelData[pos] == 1 and not unitsMap[pos]) {
-            auto hero = heroTemplate->clone();
-            this->hero = hero.get();
-            this->hero->pos = pos;
-            unitsMap[pos] = std::move(hero);
-            break;
-        } else {
-            i--;
-        }
-    }
-    for (int i = 0; i < ENEMIESCOUNT; i++) {
-        Coord2i pos{ Random::get(0, LEVEL_COLS - 1), Random::get(0, LEVEL_ROWS - 1) };
-        if (levelData[pos] == 1 and not unitsMap[pos]) {
-            auto enemy = detail::cloneAny(enemyTypes);
-            enemy->pos = pos;
-            unitsMap[pos] = std::move(enemy);
-        } else {
-            i--;
-        }
-    }
-}
-
 void Game::clearBuffers() {
     message.clear();
     bar.clear();
@@ -472,83 +387,73 @@ void Game::displayMessages() {
         .display();
 }
 
-SymbolRenderData Game::getRenderData(Item const & item) {
-    if (itemRenderData.count(item.id))
-        return itemRenderData.at(item.id);
-    return { '?', { TextStyle::Bold, TerminalColor{ Color::Green, Color::Magenta } } };
-}
-
-SymbolRenderData Game::getRenderData(Unit const & unit) {
-    if (unitRenderData.count(unit.id))
-        return unitRenderData.at(unit.id);
-    return { '?', { TextStyle::Bold, TerminalColor{ Color::Magenta, Color::Green } } };
-}
-
-tl::optional<CellRenderData> Game::getRenderData(Coord2i cell) {
-    bool const heroSeenThisCell = hero->seenUpdated(cell);
-    if (not heroSeenThisCell)
-        return tl::nullopt;
+PackedCell Game::getGroundRenderData(Coord2i cell) const {
+    auto const & itemsMap = currLevel->items;
+    int itemCount = itemsMap.count(cell);
+    if (itemCount == 1)
+        return data.getRenderData(*itemsMap[cell].front());
+    if (itemCount > 1)
+        return PackedCell{ '^', { TextStyle::Bold, TerminalColor{ Color::Black, Color::White } } };
 
-    CellRenderData renderData;
-    if (unitsMap[cell]) {
-        renderData.unit = getRenderData(*unitsMap[cell]);
-    }
-    if (itemsMap[cell].size() == 1) {
-        renderData.item = getRenderData(*itemsMap[cell].front());
-    } else if (itemsMap[cell].size() > 1) {
-        renderData.item = SymbolRenderData{ '^', { TextStyle::Bold, TerminalColor{ Color::Black, Color::White } } };
-    }
-    switch (levelData[cell]) {
-        case 1:
-            if (heroSeenThisCell) {
-                renderData.level = '.';
-            } else {
-                renderData.level = ' ';
-            }
-            break;
-        case 2:
-            if (heroSeenThisCell) {
-                renderData.level = SymbolRenderData{ '#', { TextStyle::Bold } };
-            } else {
-                renderData.level = '#';
-            }
-            break;
-        default:
-            throw std::logic_error(format("Unknown block id: {}", levelData[cell]));
-    }
-    return renderData;
+    if (currLevel->isStairsDown(cell))
+        return PackedCell{ '>', { TextStyle::Bold } };
+    if (currLevel->isStairsUp(cell))
+        return PackedCell{ '<', { TextStyle::Bold } };
+    return currLevel->tileTypes.at(currLevel->tiles[cell]).symbol;
 }
 
-void Game::clearCachedMap() {
-    cachedMap.forEach([] (tl::optional<CellRenderData> & cell) {
-        cell = tl::nullopt;
-    });
+void Game::forgetMap() {
+    currLevel->remembered = Array2D<PackedCell, LEVEL_ROWS, LEVEL_COLS>{};
 }
 
 void Game::drawMap() {
     termRend.setCursorPosition(Coord2i{});
 
-    if (mode == 2 and not hero->isMapInInventory())
-        clearCachedMap();
+    if (mode == 2 and not hero->isMapInInventory(data))
+        forgetMap();
+
+    for (Coord2i pos{}; pos.y < LEVEL_ROWS; ++pos.y) {
+        for (pos.x = 0; pos.x < LEVEL_COLS; ++pos.x) {
+            // cells out of view show what is remembered of them, units are never remembered
+            PackedCell & remembered = currLevel->remembered[pos];
+            PackedCell shown = remembered;
+            if (hero->seenUpdated(pos)) {
+                PackedCell ground = getGroundRenderData(pos);
+                remembered = ground.isRemembered() ? ground : PackedCell{};
+                auto const & unit = currLevel->units[pos];
+                shown = unit ? data.getRenderData(*unit) : ground;
+            }
 
-    cachedMap.forEach([&] (Coord2i pos, tl::optional<CellRenderData> & cellCache) {
-        auto cell = getRenderData(pos);
+            termRend
+                .setCursorPosition(pos)
+                .put(shown.getGlyph(), shown.getStyle());
+        }
+    }
+}
 
-        if (cell.has_value())
-            cellCache = cell->forCache();
+void Game::setRandomPotionEffects() {
+    for (auto const & [id, _] : data.getPotionTypes()) {
+        potionEffects[id] = Potion::Effect(Random::get(0, Potion::EffectCount - 1));
+    }
+}
 
-        auto rendData = cell.disjunction(cellCache)->get().value_or(' ');
+std::string Game::getItemName(Item const & item) const {
+    if (item.getType() != Item::Type::Potion or not isPotionKnown(item.getTypeID()))
+        return item.getName();
 
-        termRend
-            .setCursorPosition(pos)
-            .put(rendData.symbol, rendData.style);
-    });
+    switch (getPotionEffect(item.getTypeID())) {
+        case Potion::Heal: return "a potion of healing";
+        case Potion::Invisibility: return "a potion of invisibility";
+        case Potion::Teleport: return "a potion of teleport";
+        case Potion::None: return "a potion of... Water?";
+        case Potion::Blindness: return "a potion of blindness";
+        default: throw std::logic_error("Unknown potion effect");
+    }
 }
 
-void Game::setRandomPotionEffects() {
-    for (auto & [id, potion] : potionTypes) {
-        potion->effect = Potion::Effect(Random::get(0, Potion::EffectCount - 1));
-    }
+void Game::pauseAnimation(double seconds) const {
+    if (animated)
+        sleep(seconds);
 }
 
 void Game::draw() {
@@ -574,16 +479,12 @@ void Game::draw() {
 
     if (hero->weapon != nullptr) {
         weaponBar = "";
-        weaponBar += hero->weapon->getName();
+        weaponBar += getItemName(*hero->weapon);
         if (hero->weapon->isRanged) {
             weaponBar += "[";
-            for (int i = 0; i < hero->weapon->cartridge.getCapacity(); i++) {
-                if (hero->weapon->cartridge[i]) {
-                    weaponBar += "i";
-                } else {
-                    weaponBar += "_";
-                }
-            }
+            auto const & cartridge = hero->weapon->cartridge;
+            weaponBar.append(cartridge.getCurrSize(), 'i');
+            weaponBar.append(cartridge.getCapacity() - cartridge.getCurrSize(), '_');
             weaponBar += "]";
         }
     }
@@ -597,89 +498,6 @@ void Game::draw() {
         .setCursorPosition(hero->pos);
 }
 
-void Game::initField() {
-    levelData.forEach([] (int & cell) {
-        cell = 1;
-    });
-}
-
-void Game::readMap() {
-    std::ifstream file{ "map.me" };
-    levelData.forEach([&] (int & cell) {
-        file >> cell;
-    });
-}
-
-ItemPile::iterator Game::findItemAt(Coord2i cell, std::string_view id) {
-    auto & pile = itemsMap[cell];
-    return std::find_if(begin(pile), end(pile), [id] (Ptr<Item> const & item) {
-        return item->id == id;
-    });
-}
-
-bool Game::randomlySetOnMap(Ptr<Item> item) {
-    int const attemts = 32;
-
-    for (int i = 0; i < attemts; ++i) {
-        Coord2i cell{ Random::get(0, LEVEL_COLS - 1),
-                      Random::get(0, LEVEL_ROWS - 1) };
-
-        if (g_game.level()[cell] == 1) {
-            drop(std::move(item), cell);
-            return true;
-        }
-    }
-
-    return false;
-}
-
 void Game::drop(Ptr<Item> item, Coord2i cell) {
-    if (g_game.level()[cell] == 2)
-        throw std::logic_error("Trying to drop an item in a wall");
-    if (not item)
-        return;
-    item->pos = cell;
-    if (item->isStackable) {
-        auto it = findItemAt(cell, item->id);
-        if (it != end(itemsMap[cell])) {
-            (*it)->count += item->count;
-            return;
-        }
-    }
-    itemsMap[cell].push_back(std::move(item));
-}
-
-Ptr<Item> Game::createItem(std::string const & id) {
-    {
-        auto it = foodTypes.find(id);
-        if (it != foodTypes.end())
-            return it->second->clone();
-    }
-    {
-        auto it = armorTypes.find(id);
-        if (it != armorTypes.end())
-            return it->second->clone();
-    }
-    {
-        auto it = ammoTypes.find(id);
-        if (it != ammoTypes.end())
-            return it->second->clone();
-    }
-    {
-        auto it = potionTypes.find(id);
-        if (it != potionTypes.end())
-            return it->second->clone();
-    }
-    {
-        auto it = scrollTypes.find(id);
-        if (it != scrollTypes.end())
-            return it->second->clone();
-    }
-    {
-        auto it = weaponTypes.find(id);
-        if (it != weaponTypes.end())
-            return it->second->clone();
-    }
-    return {};
+    currLevel->drop(std::move(item), cell);
 }
-
@@ -0,0 +1,284 @@
+#include<game_data.hpp>
+
+#include<items/food.hpp>
+#include<items/armor.hpp>
+#include<items/ammo.hpp>
+#include<items/weapon.hpp>
+#include<items/potion.hpp>
+#include<items/scroll.hpp>
+#include<units/unit.hpp>
+#include<units/hero.hpp>
+#include<units/enemy.hpp>
+#include<yaml_item_loader.hpp>
+#include<yaml_file_cache.hpp>
+#include<yaml_unit_loader.hpp>
+#include<tile_types.hpp>
+
+#include<fmt/format.h>
+
+#include<tl/optional.hpp>
+
+#include<memory>
+#include<sstream>
+#include<stdexcept>
+
+GameData::GameData() = default;
+
+GameData::~GameData() = default;
+
+void GameData::setHeroTemplate(Ptr<Hero> newHeroTemplate) {
+    heroTemplate = std::move(newHeroTemplate);
+}
+
+tl::optional<Color> toColor(std::string_view colorString) {
+    if (colorString == "black") {
+        return Color::Black;
+    } else if (colorString == "red") {
+        return Color::Red;
+    } else if (colorString == "green") {
+        return Color::Green;
+    } else if (colorString == "yellow") {
+        return Color::Yellow;
+    } else if (colorString == "blue") {
+        return Color::Blue;
+    } else if (colorString == "magenta") {
+        return Color::Magenta;
+    } else if (colorString == "cyan") {
+        return Color::Cyan;
+    } else if (colorString == "white") {
+        return Color::White;
+    } else {
+        return tl::nullopt;
+    }
+}
+
+tl::optional<TextStyle> toTextStyle(YAML::Node const & colorData) {
+    TextStyle style;
+    std::istringstream iss(colorData["fg"].as<std::string>());
+    std::string fgString;
+    iss >> fgString;
+    if (fgString == "light") {
+        style += TextStyle::Bold;
+        iss >> fgString;
+    }
+    return toColor(fgString).and_then([&colorData] (Color fg) {
+        if (colorData["bg"]) {
+            return toColor(colorData["bg"].as<std::string>()).and_then([fg](Color bg) {
+                return tl::optional{TerminalColor{fg, bg}};
+            });
+        }
+        return tl::optional{TerminalColor{fg}};
+    }).map([&style] (TerminalColor color) {
+        return style += color;
+    });
+}
+
+tl::optional<PackedCell> toPackedCell(YAML::Node const & renderData) {
+    char symbol = renderData["symbol"].as<char>();
+    bool remembered = not renderData["remembered"] or renderData["remembered"].as<bool>();
+    if (not renderData["color"]) {
+        TextStyle style;
+        if (renderData["bold"] and renderData["bold"].as<bool>())
+            style += TextStyle::Bold;
+        return PackedCell{ symbol, style, remembered };
+    } else {
+        return toTextStyle(renderData["color"]).map([symbol, remembered](TextStyle style) {
+            return PackedCell{ symbol, style, remembered };
+        });
+    }
+}
+
+void GameData::readItemRenderData(std::string const & id, YAMLFileCache & yamlFileCache) {
+    std::string filename = fmt::format("data/items/{}.yaml", id);
+    auto const & itemData = yamlFileCache[filename];
+    if (not itemData["render"])
+        return;
+
+    TypeID typeID = itemTypeIDs.find(id);
+    if (not typeID.isValid())
+        return;
+
+    toPackedCell(itemData["render"]).map([this, typeID] (PackedCell data) {
+        if (itemRenderData.size() <= typeID.value)
+            itemRenderData.resize(typeID.value + 1);
+        itemRenderData[typeID.value] = data;
+    });
+}
+
+void GameData::readItemRenderData(YAMLFileCache & yamlFileCache) {
+    auto const & itemRegistry = yamlFileCache["data/items.yaml"];
+    for (auto const & typeEntry : itemRegistry) {
+        for (auto const & itemID : typeEntry.second) {
+            readItemRenderData(itemID.as<std::string>(), yamlFileCache);
+        }
+    }
+}
+
+void GameData::readUnitRenderData(std::string const & id, YAML::Node const & renderData) {
+    if (not renderData)
+        return;
+
+    TypeID typeID = unitTypeIDs.intern(id);
+    toPackedCell(renderData).map([this, typeID] (PackedCell data) {
+        if (unitRenderData.size() <= typeID.value)
+            unitRenderData.resize(typeID.value + 1);
+        unitRenderData[typeID.value] = data;
+    });
+}
+
+void GameData::readHeroRenderData(YAMLFileCache & yamlFileCache) {
+    YAML::Node heroData = yamlFileCache["data/units/hero.yaml"];
+    readUnitRenderData("hero", heroData["render"]);
+}
+
+void GameData::readEnemyRenderData(std::string const & id, YAMLFileCache & yamlFileCache) {
+    std::string filename = fmt::format("data/units/enemies/{}.yaml", id);
+    YAML::Node enemyData = yamlFileCache[filename];
+    readUnitRenderData(id, enemyData["render"]);
+}
+
+void GameData::readUnitRenderData(YAMLFileCache & yamlFileCache) {
+    readHeroRenderData(yamlFileCache);
+
+    auto const & enemyRegistry = yamlFileCache["data/units/enemies.yaml"];
+    for (auto const & id : enemyRegistry) {
+        readEnemyRenderData(id.as<std::string>(), yamlFileCache);
+    }
+}
+
+void GameData::readTileTypes(YAMLFileCache & yamlFileCache) {
+    TileTypes loaded;
+    for (auto const & tileData : yamlFileCache["data/tiles.yaml"]) {
+        int id = tileData["id"].as<int>();
+        if (id <= 0 or id >= TileTypes::COUNT)
+            throw std::logic_error(fmt::format("Tile id {} is out of [1, {}]", id, TileTypes::COUNT - 1));
+
+        auto flag = [&tileData] (char const * name) {
+            return tileData[name] and tileData[name].as<bool>();
+        };
+
+        TileType type;
+        type.name = tileData["name"].as<std::string>();
+        type.symbol = toPackedCell(tileData["render"]).value_or(PackedCell{ '?' });
+        type.walkable = flag("walkable");
+        type.opaque = flag("opaque");
+        type.diggable = flag("diggable");
+        loaded.add(static_cast<Tile>(id), std::move(type));
+    }
+
+    // levels are generated out of these, and digging makes floor
+    if (not loaded.isWalkable(tile::FLOOR))
+        throw std::logic_error(fmt::format("Tile {} has to be a walkable floor", tile::FLOOR));
+    if (not loaded.isDefined(tile::WALL) or loaded.isWalkable(tile::WALL))
+        throw std::logic_error(fmt::format("Tile {} has to be a wall", tile::WALL));
+    tileTypes = std::move(loaded);
+}
+
+void GameData::load() {
+    YAMLFileCache yamlFileCache;
+    readTileTypes(yamlFileCache);
+
+    std::unique_ptr<AbstractItemLoader> itemLoader(new YAMLItemLoader(yamlFileCache, *this));
+    itemLoader->load();
+
+    indexItemTypes();
+    readItemRenderData(yamlFileCache);
+
+    builtinItemTypes.map = itemTypeIDs.find("map");
+    builtinItemTypes.steelBullets = itemTypeIDs.find("steel_bullets");
+    builtinItemTypes.shotgunBullets = itemTypeIDs.find("shotgun_bullets");
+
+    std::unique_ptr<AbstractUnitLoader> unitLoader(new YAMLUnitLoader(yamlFileCache, *this));
+    unitLoader->load();
+
+    readUnitRenderData(yamlFileCache);
+    readSpawnTables(yamlFileCache);
+
+    maxEnemyVision = 0;
+    for (auto const & [id, enemy] : enemyTypes)
+        maxEnemyVision = std::max(maxEnemyVision, enemy->vision);
+}
+
+namespace {
+    template<class ItemType>
+    GameData::ItemTypeRange indexItemRegistry(Registry<Ptr<ItemType>> const & types, std::vector<Item const *> & prototypes) {
+        GameData::ItemTypeRange range;
+        if (types.empty())
+            return range;
+
+        range.first = types.begin()->first.value;
+        range.last = range.first + types.size();
+        for (auto const & [id, prototype] : types) {
+            if (not range.contains(id))
+                throw std::logic_error(fmt::format("Item type '{}' breaks the TypeID range of its category", prototype->getID()));
+            prototypes[id.value] = prototype.get();
+        }
+        return range;
+    }
+}
+
+void GameData::indexItemTypes() {
+    itemPrototypes.assign(itemTypeIDs.size(), nullptr);
+    itemTypeRanges[static_cast<int>(Item::Type::Food)] = indexItemRegistry(foodTypes, itemPrototypes);
+    itemTypeRanges[static_cast<int>(Item::Type::Armor)] = indexItemRegistry(armorTypes, itemPrototypes);
+    itemTypeRanges[static_cast<int>(Item::Type::Weapon)] = indexItemRegistry(weaponTypes, itemPrototypes);
+    itemTypeRanges[static_cast<int>(Item::Type::Ammo)] = indexItemRegistry(ammoTypes, itemPrototypes);
+    itemTypeRanges[static_cast<int>(Item::Type::Scroll)] = indexItemRegistry(scrollTypes, itemPrototypes);
+    itemTypeRanges[static_cast<int>(Item::Type::Potion)] = indexItemRegistry(potionTypes, itemPrototypes);
+}
+
+void GameData::readSpawnTables(YAMLFileCache & yamlFileCache) {
+    itemSpawnTable = readSpawnTable(yamlFileCache["data/spawn/items.yaml"], itemTypeIDs);
+    for (auto const & entry : itemSpawnTable.getEntries()) {
+        if (entry.count and not itemPrototypes.at(entry.typeID.value)->isStackable())
+            throw std::logic_error(fmt::format("Spawn count is set for non-stackable item '{}'",
+                        itemTypeIDs.getName(entry.typeID)));
+    }
+
+    enemySpawnTable = readSpawnTable(yamlFileCache["data/spawn/enemies.yaml"], unitTypeIDs);
+    for (auto const & entry : enemySpawnTable.getEntries()) {
+        if (not enemyTypes.count(entry.typeID))
+            throw std::logic_error(fmt::format("'{}' in the enemy spawn table is not an enemy",
+                        unitTypeIDs.getName(entry.typeID)));
+    }
+}
+
+PackedCell GameData::getRenderData(Item const & item) const {
+    int index = item.getTypeID().value;
+    if (index < itemRenderData.size() and not itemRenderData[index].isEmpty())
+        return itemRenderData[index];
+    return { '?', { TextStyle::Bold, TerminalColor{ Color::Green, Color::Magenta } } };
+}
+
+PackedCell GameData::getRenderData(Unit const & unit) const {
+    int index = unit.typeID.value;
+    if (index >= 0 and index < unitRenderData.size() and not unitRenderData[index].isEmpty())
+        return unitRenderData[index];
+    return { '?', { TextStyle::Bold, TerminalColor{ Color::Magenta, Color::Green } } };
+}
+
+ItemTypeInfo & GameData::addItemType(std::string const & id) {
+    TypeID typeID = itemTypeIDs.intern(id);
+    if (itemTypeInfos.size() <= typeID.value)
+        itemTypeInfos.resize(typeID.value + 1);
+    auto & info = itemTypeInfos[typeID.value];
+    info.typeID = typeID;
+    info.id = id;
+    return info;
+}
+
+void GameData::clearItemTypes() {
+    itemTypeInfos.clear();
+    itemTypeIDs.clear();
+    itemRenderData.clear();
+}
+
+Ptr<Item> GameData::createItem(std::string const & id) const {
+    return createItem(itemTypeIDs.find(id));
+}
+
+Ptr<Item> GameData::createItem(TypeID id) const {
+    if (not id.isValid() or id.value >= itemPrototypes.size() or not itemPrototypes[id.value])
+        return {};
+    return itemPrototypes[id.value]->cloneItem();
+}
@@ -0,0 +1,215 @@
+#include<gen_caves.hpp>
+
+#include<utility>
+
+namespace {
+    using Word = std::uint64_t;
+
+    Word const ALL_WALLS = ~Word(0);
+
+    int const CAVE_ATTEMPTS = 8;
+
+    Word randomWord(LevelRandom & random) {
+        Word high = random.next();
+        return high << 32 | random.next();
+    }
+
+    // bit i of the result is the cell to the left of bit i of `words[k]`
+    Word westOf(Word const * words, int k) {
+        Word prev = k > 0 ? words[k - 1] : ALL_WALLS;
+        return words[k] << 1 | prev >> 63;
+    }
+
+    // bit i of the result is the cell to the right of bit i of `words[k]`
+    Word eastOf(Word const * words, int k, int wordCount) {
+        Word next = k + 1 < wordCount ? words[k + 1] : ALL_WALLS;
+        return words[k] >> 1 | next << 63;
+    }
+
+    // `nextWall(wall, ones, twos, fours, eights)` gets the cells as bits of a word and their
+    // neighbour counts as ones + 2 * twos + 4 * fours + 8 * eights, returns the next cells
+    template<class NextWall>
+    void stepWith(gen::BitGrid const & from, gen::BitGrid & to, NextWall nextWall) {
+        int const rows = from.getRows();
+        int const wordCount = from.getWordsPerRow();
+        std::vector<Word> const outside(wordCount, ALL_WALLS);
+
+        for (int r = 0; r < rows; ++r) {
+            Word const * up = r > 0 ? from.row(r - 1) : outside.data();
+            Word const * mid = from.row(r);
+            Word const * down = r + 1 < rows ? from.row(r + 1) : outside.data();
+            Word * out = to.row(r);
+
+            for (int k = 0; k < wordCount; ++k) {
+                Word nw = westOf(up, k), n = up[k], ne = eastOf(up, k, wordCount);
+                Word w = westOf(mid, k), e = eastOf(mid, k, wordCount);
+                Word sw = westOf(down, k), s = down[k], se = eastOf(down, k, wordCount);
+
+                // every row of three as sum + 2 * carry, then full adders over the columns of bits
+                Word upSum = nw ^ n ^ ne;
+                Word upCarry = (nw & n) | (ne & (nw ^ n));
+                Word downSum = sw ^ s ^ se;
+                Word downCarry = (sw & s) | (se & (sw ^ s));
+                Word midSum = w ^ e;
+                Word midCarry = w & e;
+
+                Word ones = upSum ^ downSum ^ midSum;
+                Word onesCarry = (upSum & downSum) | (midSum & (upSum ^ downSum));
+                Word carrySum = upCarry ^ downCarry ^ midCarry;
+                Word carryCarry = (upCarry & downCarry) | (midCarry & (upCarry ^ downCarry));
+                Word twos = carrySum ^ onesCarry;
+                Word twosCarry = carrySum & onesCarry;
+                Word fours = carryCarry ^ twosCarry;
+                Word eights = carryCarry & twosCarry;
+
+                out[k] = nextWall(mid[k], ones, twos, fours, eights);
+            }
+        }
+        to.fixPadding();
+    }
+
+    void closeBorder(gen::BitGrid & grid) {
+        int rows = grid.getRows();
+        int cols = grid.getCols();
+        for (int k = 0; k < grid.getWordsPerRow(); ++k) {
+            grid.row(0)[k] = ALL_WALLS;
+            grid.row(rows - 1)[k] = ALL_WALLS;
+        }
+        for (int r = 0; r < rows; ++r) {
+            grid.setWall(r, 0, true);
+            grid.setWall(r, cols - 1, true);
+        }
+    }
+}
+
+namespace gen {
+    BitGrid::BitGrid(int rows, int cols)
+        : rows(rows)
+        , cols(cols)
+        , wordsPerRow((cols + 63) / 64)
+        , words(std::size_t(rows) * wordsPerRow, ALL_WALLS) {}
+
+    void BitGrid::setWall(int r, int c, bool wall) {
+        std::uint64_t bit = std::uint64_t(1) << (c % 64);
+        std::uint64_t & word = row(r)[c / 64];
+        word = wall ? word | bit : word & ~bit;
+    }
+
+    void BitGrid::fixPadding() {
+        int usedBits = cols % 64;
+        if (usedBits == 0)
+            return;
+        std::uint64_t padding = ALL_WALLS << usedBits;
+        for (int r = 0; r < rows; ++r)
+            row(r)[wordsPerRow - 1] |= padding;
+    }
+
+    void fillCaveNoise(BitGrid & grid, LevelRandom & random) {
+        for (int r = 0; r < grid.getRows(); ++r) {
+            for (int k = 0; k < grid.getWordsPerRow(); ++k) {
+                // each bit is set with probability 1/2 * (1 - 1/8)
+                std::uint64_t a = randomWord(random);
+                std::uint64_t b = randomWord(random);
+                std::uint64_t c = randomWord(random);
+                std::uint64_t d = randomWord(random);
+                grid.row(r)[k] = a & (b | c | d);
+            }
+        }
+        grid.fixPadding();
+        closeBorder(grid);
+    }
+
+    void stepCaves(BitGrid const & from, BitGrid & to, CaveRule rule) {
+        if (rule.birth == CAVE_RULE.birth and rule.survival == CAVE_RULE.survival) {
+            // at least 5 walls, or at least 4 for a wall: 8 or 4 with any of the lower bits set
+            stepWith(from, to, [] (Word wall, Word ones, Word twos, Word fours, Word eights) {
+                return eights | (fours & (ones | twos | wall));
+            });
+            return;
+        }
+
+        stepWith(from, to, [rule] (Word wall, Word ones, Word twos, Word fours, Word eights) {
+            Word born = 0;
+            Word kept = 0;
+            for (int count = 0; count <= 8; ++count) {
+                bool births = rule.birth >> count & 1;
+                bool survives = rule.survival >> count & 1;
+                if (not births and not survives)
+                    continue;
+                Word matches = (count & 1 ? ones : ~ones)
+                    & (count & 2 ? twos : ~twos)
+                    & (count & 4 ? fours : ~fours)
+                    & (count & 8 ? eights : ~eights);
+                if (births)
+                    born |= matches;
+                if (survives)
+                    kept |= matches;
+            }
+            return (wall & kept) | (~wall & born);
+        });
+    }
+
+    int keepLargestCave(BitGrid & grid) {
+        int const rows = grid.getRows();
+        int const cols = grid.getCols();
+        std::vector<int> regions(std::size_t(rows) * cols, -1);
+        std::vector<int> stack;
+        int largest = -1;
+        int largestSize = 0;
+        int regionCount = 0;
+
+        for (int start = 0; start < rows * cols; ++start) {
+            if (regions[start] != -1 or grid.isWall(start / cols, start % cols))
+                continue;
+
+            // the hero walks diagonally too, so diagonal neighbours are the same cave
+            int region = regionCount++;
+            int size = 0;
+            regions[start] = region;
+            stack.push_back(start);
+            while (not stack.empty()) {
+                int cell = stack.back();
+                stack.pop_back();
+                ++size;
+                int r = cell / cols;
+                int c = cell % cols;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        int nr = r + dr;
+                        int nc = c + dc;
+                        if (nr < 0 or nc < 0 or nr >= rows or nc >= cols)
+                            continue;
+                        int near = nr * cols + nc;
+                        if (regions[near] == -1 and not grid.isWall(nr, nc)) {
+                            regions[near] = region;
+                            stack.push_back(near);
+                        }
+                    }
+                }
+            }
+            if (size > largestSize) {
+                largest = region;
+                largestSize = size;
+            }
+        }
+
+        for (int cell = 0; cell < rows * cols; ++cell)
+            if (regions[cell] != -1 and regions[cell] != largest)
+                grid.setWall(cell / cols, cell % cols, true);
+        return largestSize;
+    }
+
+    void generateCaves(BitGrid & grid, LevelRandom & random) {
+        BitGrid next(grid.getRows(), grid.getCols());
+        for (int attempt = 0; attempt < CAVE_ATTEMPTS; ++attempt) {
+            fillCaveNoise(grid, random);
+            for (int step = 0; step < CAVE_STEPS; ++step) {
+                stepCaves(grid, next, CAVE_RULE);
+                std::swap(grid, next);
+            }
+            closeBorder(grid);
+            if (keepLargestCave(grid) * 3 >= grid.getRows() * grid.getCols())
+                return;
+        }
+    }
+}
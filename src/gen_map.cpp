@@ -1,83 +1,81 @@
+#include<gen_map.hpp>
+
 #include<algorithm>
 #include<vector>
-#include<effolkronium/random.hpp>
-
-#include<game.hpp>
-#include<utils.hpp>
 
-using Random = effolkronium::random_static;
-
-int const ROOMS_COUNT = 3;
-int const COLS = (LEVEL_COLS - 1) / 2;
-int const ROWS = (LEVEL_ROWS - 1) / 2;
+namespace {
+    // Maze cell `mazeCell` of a maze `mazeCols` cells wide, as an index into the level tiles
+    std::size_t toTileIndex(int mazeCell, int mazeCols, int cols) {
+        int x = mazeCell % mazeCols * 2 + 1;
+        int y = mazeCell / mazeCols * 2 + 1;
+        return std::size_t(y) * cols + x;
+    }
+}
 
-Array2D<bool, ROWS, COLS> used;
+void gen::carveMaze(Tile * tiles, int rows, int cols, LevelRandom & random) {
+    int const mazeCols = (cols - 1) / 2;
+    int const mazeRows = (rows - 1) / 2;
+    int const mazeSize = mazeCols * mazeRows;
 
-void mazeNext(Coord2i start, Coord2i prev, Coord2i curr) {
-    if (start == curr and used[start]) {
+    std::fill(tiles, tiles + std::size_t(rows) * cols, tile::WALL);
+    if (mazeSize == 0)
         return;
-    }
 
-    auto & level = g_game.level();
+    std::vector<bool> visited(mazeSize);
+    std::vector<int> stack;
+    stack.reserve(mazeSize);
 
-    used[curr] = true;
-    Coord2i cell = curr * 2 + 1;
-    for (int i = cell.y - 1; i <= cell.y + 1; ++i) {
-        for (int j = cell.x - 1; j <= cell.x + 1; ++j) {
-            level.at(i, j) = 2;
-        }
-    }
-    level[cell] = 1;
-    level[cell + (prev - curr)] = 1;
+    visited[0] = true;
+    tiles[toTileIndex(0, mazeCols, cols)] = tile::FLOOR;
+    stack.push_back(0);
 
-    Vec2i dirs[4] = {
-        Vec2i{  0, -1 },
-        Vec2i{  0,  1 },
-        Vec2i{ -1,  0 },
-        Vec2i{  1,  0 }
-    };
+    while (not stack.empty()) {
+        int curr = stack.back();
+        int x = curr % mazeCols;
+        int y = curr / mazeCols;
 
-    while (true) {
-        std::vector<Coord2i> neighbors;
-        for (auto dir : dirs) {
-            auto next = curr + dir;
-            if (used.isIndex(next) and not used[next]) {
-                neighbors.push_back(next);
-            }
-        }
-        if (neighbors.empty())
-            return;
-        auto next = *Random::get(neighbors);
-        mazeNext(start, curr, next);
-    }
-}
+        int neighbors[4];
+        int count = 0;
+        if (y > 0 and not visited[curr - mazeCols])
+            neighbors[count++] = curr - mazeCols;
+        if (y + 1 < mazeRows and not visited[curr + mazeCols])
+            neighbors[count++] = curr + mazeCols;
+        if (x > 0 and not visited[curr - 1])
+            neighbors[count++] = curr - 1;
+        if (x + 1 < mazeCols and not visited[curr + 1])
+            neighbors[count++] = curr + 1;
 
-void clearRoom(Coord2i a, Coord2i b) {
-    if (a.x > b.x)
-        std::swap(a.x, b.x);
-    if (a.y > b.y)
-        std::swap(a.y, b.y);
-    for (int r = a.y; r <= b.y; ++r) {
-        for (int c = a.x; c <= b.x; ++c) {
-            g_game.level().at(r, c) = 1;
+        if (count == 0) {
+            stack.pop_back();
+            continue;
         }
+
+        int next = neighbors[random.below(count)];
+        std::size_t from = toTileIndex(curr, mazeCols, cols);
+        std::size_t to = toTileIndex(next, mazeCols, cols);
+        tiles[(from + to) / 2] = tile::FLOOR;
+        tiles[to] = tile::FLOOR;
+        visited[next] = true;
+        stack.push_back(next);
     }
 }
 
-void generateRooms() {
+void gen::carveRooms(Tile * tiles, int rows, int cols, LevelRandom & random) {
+    int const mazeCols = (cols - 1) / 2;
+    int const mazeRows = (rows - 1) / 2;
     for (int i = 0; i < ROOMS_COUNT; ++i) {
-        Size2i roomSize{ Random::get(5, 6), Random::get(2, 3) };
-        Coord2i upLeftCorner{ Random::get(0, COLS - roomSize.x), Random::get(0, ROWS - roomSize.y) };
-        Coord2i downRightCorner = upLeftCorner + roomSize - 1;
-        clearRoom(upLeftCorner * 2 + 1, downRightCorner * 2 + 1);
+        Size2i roomSize{ random.between(5, 6), random.between(2, 3) };
+        if (roomSize.x > mazeCols or roomSize.y > mazeRows)
+            continue;
+        Coord2i upLeftCorner{ random.between(0, mazeCols - roomSize.x), random.between(0, mazeRows - roomSize.y) };
+        Coord2i first = upLeftCorner * 2 + 1;
+        Coord2i last = (upLeftCorner + roomSize - 1) * 2 + 1;
+        for (int r = first.y; r <= last.y; ++r)
+            std::fill(tiles + std::size_t(r) * cols + first.x, tiles + std::size_t(r) * cols + last.x + 1, tile::FLOOR);
     }
 }
 
-#include<iostream>
-
-void generateMaze() {
-    Coord2i start;
-    mazeNext(start, start, start);
-    generateRooms();
+void gen::generateMaze(Tile * tiles, int rows, int cols, LevelRandom & random) {
+    carveMaze(tiles, rows, cols, random);
+    carveRooms(tiles, rows, cols, random);
 }
-
@@ -0,0 +1,144 @@
+#include<gen_stream.hpp>
+#include<gen_map.hpp>
+#include<level.hpp>
+
+#include<algorithm>
+#include<vector>
+
+namespace {
+    // A level has this many maze cells and ROOMS_COUNT rooms, bands of the stream keep the same density
+    int const LEVEL_MAZE_CELLS = (LEVEL_COLS - 1) / 2 * ((LEVEL_ROWS - 1) / 2);
+
+    // Eller's algorithm over maze rows of a fixed width. Sets are relabeled to [0, mazeCols)
+    // on every row, so all the state is a few arrays of that size.
+    class EllerMaze {
+    public:
+        EllerMaze(int mazeCols, LevelRandom & random)
+            : mazeCols(mazeCols)
+            , random(random)
+            , sets(mazeCols, -1)
+            , parent(mazeCols)
+            , remap(mazeCols, -1)
+            , remaining(mazeCols)
+            , wentDown(mazeCols) {}
+
+        // Carves the next maze row into `cellRow` and the passages down from it into
+        // `passageRow`, both are level rows filled with walls. The last row joins all sets.
+        void carveRow(bool last, Tile * cellRow, Tile * passageRow) {
+            int setCount = relabel();
+
+            for (int s = 0; s < setCount; ++s)
+                parent[s] = s;
+            for (int x = 0; x < mazeCols; ++x)
+                cellRow[2 * x + 1] = tile::FLOOR;
+
+            for (int x = 0; x + 1 < mazeCols; ++x) {
+                int left = find(sets[x]);
+                int right = find(sets[x + 1]);
+                if (left != right and (last or random.below(2) == 0)) {
+                    parent[right] = left;
+                    cellRow[2 * x + 2] = tile::FLOOR;
+                }
+            }
+            for (int x = 0; x < mazeCols; ++x)
+                sets[x] = find(sets[x]);
+
+            if (last)
+                return;
+
+            // every set goes down at least once, otherwise it would be cut off from the rest
+            std::fill(remaining.begin(), remaining.begin() + setCount, 0);
+            std::fill(wentDown.begin(), wentDown.begin() + setCount, false);
+            for (int x = 0; x < mazeCols; ++x)
+                ++remaining[sets[x]];
+            for (int x = 0; x < mazeCols; ++x) {
+                int set = sets[x];
+                --remaining[set];
+                if (random.below(2) == 0 or (remaining[set] == 0 and not wentDown[set])) {
+                    wentDown[set] = true;
+                    passageRow[2 * x + 1] = tile::FLOOR;
+                } else {
+                    sets[x] = -1;
+                }
+            }
+        }
+
+    private:
+        // Compacts the sets carried down from the previous row and gives new cells sets of their own
+        int relabel() {
+            int count = 0;
+            for (int & set : sets) {
+                if (set < 0)
+                    continue;
+                if (remap[set] < 0)
+                    remap[set] = count++;
+                set = remap[set];
+            }
+            std::fill(remap.begin(), remap.end(), -1);
+            for (int & set : sets)
+                if (set < 0)
+                    set = count++;
+            return count;
+        }
+
+        int find(int set) {
+            while (parent[set] != set)
+                set = parent[set] = parent[parent[set]];
+            return set;
+        }
+
+        int mazeCols;
+        LevelRandom & random;
+        std::vector<int> sets;
+        std::vector<int> parent;
+        std::vector<int> remap;
+        std::vector<int> remaining;
+        std::vector<bool> wentDown;
+    };
+
+    // Same rooms as gen::carveRooms, placed within the `mazeRows` maze rows of the band
+    void carveBandRooms(std::vector<Tile> & band, int cols, int mazeCols, int mazeRows, LevelRandom & random) {
+        int roomsCount = std::max(1, gen::ROOMS_COUNT * mazeCols * mazeRows / LEVEL_MAZE_CELLS);
+        for (int i = 0; i < roomsCount; ++i) {
+            Size2i roomSize{ random.between(5, 6), random.between(2, 3) };
+            if (roomSize.x > mazeCols or roomSize.y > mazeRows)
+                continue;
+            Coord2i upLeftCorner{ random.between(0, mazeCols - roomSize.x), random.between(0, mazeRows - roomSize.y) };
+            // band row 0 is the first cell row of the band
+            Coord2i first{ upLeftCorner.x * 2 + 1, upLeftCorner.y * 2 };
+            Coord2i last{ (upLeftCorner.x + roomSize.x - 1) * 2 + 1, (upLeftCorner.y + roomSize.y - 1) * 2 };
+            for (int r = first.y; r <= last.y; ++r)
+                std::fill(band.begin() + r * cols + first.x, band.begin() + r * cols + last.x + 1, tile::FLOOR);
+        }
+    }
+}
+
+void gen::streamMaze(int rows, int cols, std::uint64_t seed, RowSink const & sink) {
+    if (rows <= 0 or cols <= 0)
+        return;
+
+    int const mazeCols = (cols - 1) / 2;
+    int const mazeRows = mazeCols == 0 ? 0 : (rows - 1) / 2;
+
+    LevelRandom random(seed);
+    EllerMaze maze(mazeCols, random);
+    std::vector<Tile> band(std::size_t(2 * BAND_MAZE_ROWS) * cols);
+
+    std::vector<Tile> walls(cols, tile::WALL);
+    sink(0, walls.data());
+
+    for (int bandFirst = 0; bandFirst < mazeRows; bandFirst += BAND_MAZE_ROWS) {
+        int bandRows = std::min(BAND_MAZE_ROWS, mazeRows - bandFirst);
+        std::fill(band.begin(), band.end(), tile::WALL);
+        for (int y = 0; y < bandRows; ++y) {
+            Tile * cellRow = band.data() + std::size_t(2 * y) * cols;
+            maze.carveRow(bandFirst + y + 1 == mazeRows, cellRow, cellRow + cols);
+        }
+        carveBandRooms(band, cols, mazeCols, bandRows, random);
+        for (int r = 0; r < 2 * bandRows; ++r)
+            sink(2 * bandFirst + 1 + r, band.data() + std::size_t(r) * cols);
+    }
+
+    for (int r = 2 * mazeRows + 1; r < rows; ++r)
+        sink(r, walls.data());
+}
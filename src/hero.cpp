@@ -2,6 +2,8 @@
 
 #include<units/enemy.hpp>
 #include<game.hpp>
+#include<line_of_sight.hpp>
+#include<fov_table.hpp>
 #include<item_list_formatters.hpp>
 #include<items/food.hpp>
 #include<items/armor.hpp>
@@ -15,26 +17,25 @@
 
 #include<effolkronium/random.hpp>
 
-#include<numeric>
 
 using namespace fmt::literals;
 using fmt::format;
-using Random = effolkronium::random_static;
+using Random = effolkronium::random_thread_local;
 
 int Hero::getLevelUpXP() const {
     return level * level + 4;
 }
 
-bool Hero::tryLevelUp() {
+bool Hero::tryLevelUp(Game & game) {
     if (xp < getLevelUpXP())
         return false;
-    levelUp();
+    levelUp(game);
     return true;
 }
 
-void Hero::levelUp() {
+void Hero::levelUp(Game & game) {
     level++;
-    g_game.addMessage(format("Now you are level {}.", level));
+    game.addMessage(format("Now you are level {}.", level));
     maxBurden += maxBurden / 4;
     maxHealth += maxHealth / 4;
     health = maxHealth;
@@ -44,36 +45,49 @@ bool Hero::isInvisible() const {
     return turnsInvisible > 0;
 }
 
-void Hero::checkVisibleCells() {
-    seenMap.forEach([this] (Coord2i pos, bool & see) {
-        see = canSee(pos);
+void Hero::checkVisibleCells(Game const & game) {
+    seenMap.forEach([] (bool & see) {
+        see = false;
+    });
+
+    auto const & level = game.getCurrentLevel();
+    if (game.getVisionModel() == VisionModel::Asymmetric) {
+        fov::forEachVisibleCell(level.tiles, level.tileTypes, pos, vision, [this] (Coord2i cell) {
+            seenMap[cell] = true;
+        });
+        return;
+    }
+
+    lineOfSightMap.forEach([] (bool & inSight) {
+        inSight = false;
+    });
+    int sightRadius = std::max(vision, game.getData().getMaxEnemyVision());
+    fov::forEachVisibleCell(level.tiles, level.tileTypes, pos, sightRadius, [this] (Coord2i cell) {
+        lineOfSightMap[cell] = true;
+        seenMap[cell] = distSquared(pos, cell) < sqr(vision);
     });
 }
 
 int Hero::getInventoryItemsWeight() const {
-    int totalWeight = 0;
-    for (auto const & entry : inventory) {
-        totalWeight += entry.second->getTotalWeight();
-    }
-    return totalWeight;
+    return inventory.getTotalWeight();
 }
 
 template<class ... FMTStrategies>
-void printList(std::string_view title, std::vector<Item const *> const & items, FMTStrategies && ... strategies) {
-    g_game.getRenderer()
+void printList(Game & game, std::string_view title, std::vector<Item const *> const & items, FMTStrategies && ... strategies) {
+    game.getRenderer()
             .setCursorPosition(Coord2i{ LEVEL_COLS + 10, 0 })
             .put(title);
 
     int lineNo = 2;
     for (int i = 0; i < items.size(); i++) {
-        g_game.getRenderer()
+        game.getRenderer()
                 .setCursorPosition(Coord2i{ LEVEL_COLS + 10, lineNo })
-                .put(formatItem(i, *items[i], std::forward<FMTStrategies>(strategies)...));
+                .put(formatItem(i, *items[i], game.getItemName(*items[i]), std::forward<FMTStrategies>(strategies)...));
         lineNo ++;
     }
 }
 
-std::pair<Hero::SelectStatus, char> Hero::selectOneFromInventory(std::string_view title, std::function<bool(Item const &)> filter) const {
+std::pair<Hero::SelectStatus, char> Hero::selectOneFromInventory(Game & game, std::string_view title, std::function<bool(Item const &)> filter) const {
     std::vector<Item const *> items;
     for (auto const & entry : inventory)
         if (filter(*entry.second))
@@ -82,17 +96,13 @@ std::pair<Hero::SelectStatus, char> Hero::selectOneFromInventory(std::string_vie
     if (items.empty())
         return { NothingToSelect, 0 };
 
-    std::sort(items.begin(), items.end(), [] (Item const * a, Item const * b) {
-        return a->inventorySymbol < b->inventorySymbol;
-    });
-
-    printList(title, items,
+    printList(game, title, items,
             formatters::LetterNumberingByInventoryID{},
             formatters::DontMark{},
             formatters::WithEquippedStatus{ weapon, armor });
 
     while (true) {
-        char choice = g_game.getReader().readChar();
+        char choice = game.getReader().readChar();
         if (choice == '\033')
             return { Cancelled, 0 };
         for (Item const * item : items)
@@ -102,6 +112,7 @@ std::pair<Hero::SelectStatus, char> Hero::selectOneFromInventory(std::string_vie
 }
 
 std::pair<Hero::SelectStatus, std::vector<char>> Hero::selectMultipleFromInventory(
+        Game & game,
         std::string_view title,
         std::function<bool(Item const &)> filter) const {
     std::vector<Item const *> items;
@@ -112,19 +123,15 @@ std::pair<Hero::SelectStatus, std::vector<char>> Hero::selectMultipleFromInvento
     if (items.empty())
         return { NothingToSelect, {} };
 
-    std::sort(items.begin(), items.end(), [] (Item const * a, Item const * b) {
-        return a->inventorySymbol < b->inventorySymbol;
-    });
-
     std::vector<bool> selected(items.size());
 
     while (true) {
-        printList(title, items,
+        printList(game, title, items,
                 formatters::LetterNumberingByInventoryID{},
                 formatters::MarkSelected{selected},
                 formatters::WithEquippedStatus{weapon, armor});
 
-        char choice = g_game.getReader().readChar();
+        char choice = game.getReader().readChar();
         if (choice == '\033')
             return {Cancelled, {}};
         if (choice == '\n') {
@@ -140,17 +147,17 @@ std::pair<Hero::SelectStatus, std::vector<char>> Hero::selectMultipleFromInvento
     }
 }
 
-std::pair<Hero::SelectStatus, int> Hero::selectOneFromList(std::string_view title, std::vector<Item const *> const & items) const {
+std::pair<Hero::SelectStatus, int> Hero::selectOneFromList(Game & game, std::string_view title, std::vector<Item const *> const & items) const {
     if (items.empty())
         return { NothingToSelect, 0 };
 
-    printList(title, items,
+    printList(game, title, items,
             formatters::LetterNumberingByIndex{},
             formatters::DontMark{},
             formatters::WithoutEquippedStatus{});
 
     while (true) {
-        char choice = g_game.getReader().readChar();
+        char choice = game.getReader().readChar();
         if (choice == '\033')
             return { Cancelled, 0 };
         if (not std::isalpha(choice))
@@ -161,19 +168,19 @@ std::pair<Hero::SelectStatus, int> Hero::selectOneFromList(std::string_view titl
     }
 }
 
-std::pair<Hero::SelectStatus, std::vector<int>> Hero::selectMultipleFromList(std::string_view title, std::vector<Item const *> const & items) const {
+std::pair<Hero::SelectStatus, std::vector<int>> Hero::selectMultipleFromList(Game & game, std::string_view title, std::vector<Item const *> const & items) const {
     if (items.empty())
         return { NothingToSelect, {} };
 
     std::vector<bool> selected(items.size());
 
     while (true) {
-        printList(title, items,
+        printList(game, title, items,
                   formatters::LetterNumberingByIndex{},
                   formatters::MarkSelected{selected},
                   formatters::WithoutEquippedStatus{});
 
-        char choice = g_game.getReader().readChar();
+        char choice = game.getReader().readChar();
         if (choice == '\033')
             return { Cancelled, {} };
         if (choice == '\n') {
@@ -191,61 +198,50 @@ std::pair<Hero::SelectStatus, std::vector<int>> Hero::selectMultipleFromList(std
     }
 }
 
-bool Hero::isMapInInventory() const {
-    for (auto const & entry : inventory)
-        if (entry.second->id == "map")
-            return true;
-    return false;
+bool Hero::isMapInInventory(GameData const & data) const {
+    return inventory.contains(data.getBuiltinItemTypes().map);
 }
 
-void Hero::pickUp() {
-    auto & itemsMap = g_game.getItemsMap();
-    if (itemsMap[pos].empty()) {
-        g_game.addMessage("There is nothing here to pick up.");
-        g_game.skipUpdate();
+void Hero::pickUp(Game & game) {
+    auto & itemsMap = game.getItemsMap();
+    if (not itemsMap.hasItems(pos)) {
+        game.addMessage("There is nothing here to pick up.");
+        game.skipUpdate();
         return;
     }
 
-    std::vector<ItemPile::iterator> iters;
-    if (itemsMap[pos].size() == 1) {
-        iters.push_back(itemsMap[pos].begin());
+    std::vector<int> indices;
+    if (itemsMap.count(pos) == 1) {
+        indices.push_back(0);
     } else {
         std::vector<Item const *> list;
         for (auto const & item : itemsMap[pos])
             list.push_back(item.get());
 
-        auto [status, indices] = selectMultipleFromList("What do you want to pick up? ", list);
-        if (status == Cancelled or indices.empty()) {
-            g_game.skipUpdate();
+        auto [status, selected] = selectMultipleFromList(game, "What do you want to pick up? ", list);
+        if (status == Cancelled or selected.empty()) {
+            game.skipUpdate();
             return;
         }
-        std::vector<int> shifts(indices.size());
-        std::adjacent_difference(indices.begin(), indices.end(), shifts.begin());
-
-        auto it = itemsMap[pos].begin();
-        for (int shift : shifts) {
-            std::advance(it, shift);
-            iters.push_back(it);
-        }
+        indices = std::move(selected);
     }
 
     bool fullInventory = false;
     bool firstPickUp = true;
     std::string message;
-    for (auto it : iters) {
-        auto & itemToPick = *it;
+    std::vector<int> picked;
+    for (int index : indices) {
+        auto & itemToPick = itemsMap.at(pos, index);
         std::string pickUpString;
 
         inventory.add(std::move(itemToPick)).doIf<AddStatus::New>(
-                [this, it, &pickUpString](AddStatus::New added) {
-            g_game.getItemsMap()[pos].erase(it);
+                [this, &game, &pickUpString](AddStatus::New added) {
             auto & item = inventory[added.at];
-            if (item.isStackable and item.count > 1)
-                pickUpString = format("{}x {} ({})", item.count, item.getName(), added.at);
+            if (item.isStackable() and item.count > 1)
+                pickUpString = format("{}x {} ({})", item.count, game.getItemName(item), added.at);
             else
-                pickUpString = format("{} ({})", item.getName(), added.at);
-        }).doIf<AddStatus::Stacked>([this, it, &pickUpString](AddStatus::Stacked stacked) {
-            g_game.getItemsMap()[pos].erase(it);
+                pickUpString = format("{} ({})", game.getItemName(item), added.at);
+        }).doIf<AddStatus::Stacked>([this, &game, &pickUpString](AddStatus::Stacked stacked) {
             auto & item = inventory[stacked.at];
 
             std::string pickedCount;
@@ -253,7 +249,7 @@ void Hero::pickUp() {
                 pickedCount = fmt::format("{}x ", stacked.pickedCount);
 
             pickUpString = fmt::format("{}{} ({}), now you have {}",
-                                 pickedCount, item.getName(), stacked.at, item.count);
+                                 pickedCount, game.getItemName(item), stacked.at, item.count);
         }).doIf<AddStatus::AddError>([&itemToPick, &fullInventory, &message](auto & err) {
             fullInventory = true;
             message += "Your inventory is full";
@@ -261,6 +257,7 @@ void Hero::pickUp() {
 
         if (fullInventory)
             break;
+        picked.push_back(index);
 
         if (firstPickUp) {
             message += "You picked up ";
@@ -271,36 +268,38 @@ void Hero::pickUp() {
         message += pickUpString;
         firstPickUp = false;
     }
+    itemsMap.erase(pos, picked);
+
     message += ".";
-    g_game.addMessage(message);
+    game.addMessage(message);
 
     if (getInventoryItemsWeight() > maxBurden and !isBurdened) {
-        g_game.addMessage("You're burdened.");
+        game.addMessage("You're burdened.");
         isBurdened = true;
     }
 }
 
-void Hero::clearRightPane() const {
+void Hero::clearRightPane(Game & game) const {
     for (int i = 0; i < 100; i++) {
         for (int j = 0; j < 50; j++) {
-            g_game.getRenderer()
+            game.getRenderer()
                 .setCursorPosition(Coord2i{ LEVEL_COLS + j + 10, i })
                 .put(' ');
         }
     }
 }
 
-void Hero::eat() {
-    auto [status, choice] = selectOneFromInventory("What do you want to eat?", [] (Item const & item) {
+void Hero::eat(Game & game) {
+    auto [status, choice] = selectOneFromInventory(game, "What do you want to eat?", [] (Item const & item) {
         return item.getType() == Item::Type::Food;
     });
     switch (status) {
         case NothingToSelect:
-            g_game.addMessage("You don't have anything to eat.");
-            g_game.skipUpdate();
+            game.addMessage("You don't have anything to eat.");
+            game.skipUpdate();
             return;
         case Cancelled:
-            g_game.skipUpdate();
+            game.skipUpdate();
             return;
         default:break;
     }
@@ -310,18 +309,14 @@ void Hero::eat() {
     if (Random::get<bool>(rottenProbability)) {
         hunger += dynamic_cast<Food &>(item).nutritionalValue / 3;
         health --;
-        g_game.addMessage("Fuck! This food was rotten!");
+        game.addMessage("Fuck! This food was rotten!");
     } else {
         hunger += dynamic_cast<Food &>(item).nutritionalValue;
     }
-    if (item.count == 1) {
-        inventory.remove(choice);
-    } else {
-        item.count--;
-    }
+    inventory.consume(choice);
 }
 
-void Hero::processInput(char inp) {
+void Hero::processInput(Game & game, char inp) {
     switch (inp) {
         case CONTROL_UP:
         case CONTROL_DOWN:
@@ -332,61 +327,67 @@ void Hero::processInput(char inp) {
         case CONTROL_DOWNLEFT:
         case CONTROL_DOWNRIGHT: {
             auto offset = toVec2i(*getDirectionByControl(inp));
-            moveTo(pos + offset);
+            moveTo(game, pos + offset);
             break;
         }
         case CONTROL_PICKUP:
-            pickUp();
+            pickUp(game);
             break;
         case CONTROL_EAT:
-            eat();
+            eat(game);
             break;
         case CONTROL_SHOWINVENTORY:
-            showInventory();
+            showInventory(game);
             break;
         case CONTROL_WEAR:
-            wearArmor();
+            wearArmor(game);
             break;
         case CONTROL_WIELD:
-            wieldWeapon();
+            wieldWeapon(game);
             break;
         case CONTROL_TAKEOFF:
             if (armor == nullptr)
-                g_game.skipUpdate();
+                game.skipUpdate();
             else
                 takeArmorOff();
             break;
         case CONTROL_UNEQUIP:
             if (weapon == nullptr)
-                g_game.skipUpdate();
+                game.skipUpdate();
             else
                 unequipWeapon();
             break;
         case CONTROL_DROP:
-            dropItems();
+            dropItems(game);
             break;
         case CONTROL_THROW:
-            throwItem();
+            throwItem(game);
             break;
         case CONTROL_SHOOT:
-            shoot();
+            shoot(game);
             break;
         case CONTROL_DRINK:
-            drinkPotion();
+            drinkPotion(game);
             break;
         case CONTROL_RELOAD:
-            reloadWeapon();
+            reloadWeapon(game);
             break;
         case CONTROL_READ:
-            readScroll();
+            readScroll(game);
+            break;
+        case CONTROL_DESCEND:
+            descend(game);
+            break;
+        case CONTROL_ASCEND:
+            ascend(game);
             break;
         case '\\': {
-            char hv = g_game.getReader().readChar();
+            char hv = game.getReader().readChar();
 
             if (hv == 'h') {
-                if (g_game.getReader().readChar() == 'e') {
-                    if (g_game.getReader().readChar() == 'a') {
-                        if (g_game.getReader().readChar() == 'l') {
+                if (game.getReader().readChar() == 'e') {
+                    if (game.getReader().readChar() == 'a') {
+                        if (game.getReader().readChar() == 'l') {
                             hunger = 3000;
                             health = maxHealth * 100;
                         }
@@ -395,29 +396,29 @@ void Hero::processInput(char inp) {
             }
 
             if (hv == 'w') {
-                if (g_game.getReader().readChar() == 'a') {
-                    if (g_game.getReader().readChar() == 'l') {
-                        if (g_game.getReader().readChar() == 'l') {
-                            if (g_game.getReader().readChar() == 's') {
+                if (game.getReader().readChar() == 'a') {
+                    if (game.getReader().readChar() == 'l') {
+                        if (game.getReader().readChar() == 'l') {
+                            if (game.getReader().readChar() == 's') {
                                 canMoveThroughWalls = true;
                             }
                         }
                     }
                 }
             } else if (hv == 'd') {
-                if (g_game.getReader().readChar() == 's') {
-                    if (g_game.getReader().readChar() == 'c') {
+                if (game.getReader().readChar() == 's') {
+                    if (game.getReader().readChar() == 'c') {
                         canMoveThroughWalls = false;
                     }
                 } else {
-                    //g_game.getItemsMap().at(1, 1).push_back(g_game.getFoodTypes()[0]->clone());
+                    //game.getItemsMap().at(1, 1).push_back(game.getFoodTypes()[0]->clone());
                 }
             } else if (hv == 'k') {
-                if (g_game.getReader().readChar() == 'i') {
-                    if (g_game.getReader().readChar() == 'l') {
-                        if (g_game.getReader().readChar() == 'l') {
+                if (game.getReader().readChar() == 'i') {
+                    if (game.getReader().readChar() == 'l') {
+                        if (game.getReader().readChar() == 'l') {
                             health -= (health * 2) / 3;
-                            g_game.addMessage("Ouch!");
+                            game.addMessage("Ouch!");
                         }
                     }
                 }
@@ -429,68 +430,89 @@ void Hero::processInput(char inp) {
     }
 }
 
-void Hero::reloadWeapon() {
+void Hero::descend(Game & game) {
+    if (not game.getCurrentLevel().isStairsDown(pos)) {
+        game.addMessage("There are no stairs down here.");
+        game.skipUpdate();
+        return;
+    }
+    game.changeFloor(game.getDepth() + 1);
+}
+
+void Hero::ascend(Game & game) {
+    if (not game.getCurrentLevel().isStairsUp(pos)) {
+        game.addMessage("There are no stairs up here.");
+        game.skipUpdate();
+        return;
+    }
+    game.changeFloor(game.getDepth() - 1);
+}
+
+void Hero::reloadWeapon(Game & game) {
     if (weapon == nullptr or not weapon->isRanged) {
-        g_game.addMessage("You have no ranged weapon in hands.");
-        g_game.skipUpdate();
+        game.addMessage("You have no ranged weapon in hands.");
+        game.skipUpdate();
         return;
     }
 
-    clearRightPane();
-    g_game.getRenderer()
+    clearRightPane(game);
+    game.getRenderer()
         .setCursorPosition(Coord2i{ LEVEL_COLS + 10 })
         .put("Now you can load your weapon");
 
     while (true) {
-        clearRightPane();
-        g_game.getRenderer()
+        clearRightPane(game);
+        game.getRenderer()
             .setCursorPosition(Coord2i{ LEVEL_COLS + 10, 1 })
             .put('[');
 
-        for (int i = 0; i < weapon->cartridge.getCapacity(); i++) {
+        for (auto const & run : weapon->cartridge) {
             TextStyle style{ TerminalColor{} };
             char symbol = 'i';
-            if (weapon->cartridge[i]) {
-                std::string_view ammoID = weapon->cartridge[i]->id;
-                if (ammoID == "steel_bullets") {
-                    style = TextStyle{TextStyle::Bold, Color::Black};
-                } else if (ammoID == "shotgun_bullets") {
-                    style = TextStyle{TextStyle::Bold, Color::Red};
-                } else {
-                    symbol = '?';
-                }
+            TypeID ammoID = run.ammo->getTypeID();
+            if (ammoID == game.getData().getBuiltinItemTypes().steelBullets) {
+                style = TextStyle{TextStyle::Bold, Color::Black};
+            } else if (ammoID == game.getData().getBuiltinItemTypes().shotgunBullets) {
+                style = TextStyle{TextStyle::Bold, Color::Red};
             } else {
-                symbol = '_';
+                symbol = '?';
+            }
+            for (int i = 0; i < run.count; i++) {
+                game.getRenderer().put(symbol, style);
             }
-            g_game.getRenderer().put(symbol, style);
         }
-        g_game.getRenderer().put(']');
+        for (int i = weapon->cartridge.getCurrSize(); i < weapon->cartridge.getCapacity(); i++) {
+            game.getRenderer().put('_', TextStyle{ TerminalColor{} });
+        }
+        game.getRenderer().put(']');
 
         int lineY = 2;
-        for (auto entry : inventory) {
-            if (entry.second->getType() != Item::Type::Ammo)
-                continue;
+        if (inventory.countOf(Item::Type::Ammo) > 0) {
+            for (auto entry : inventory) {
+                if (entry.second->getType() != Item::Type::Ammo)
+                    continue;
 
-            std::string line = format("{} - {} (x{})",
-                entry.first,
-                entry.second->getName(),
-                entry.second->count);
+                std::string line = format("{} - {} (x{})",
+                    entry.first,
+                    game.getItemName(*entry.second),
+                    entry.second->count);
 
-            g_game.getRenderer()
-                .setCursorPosition(Coord2i{ LEVEL_COLS + 10, lineY })
-                .put(line);
+                game.getRenderer()
+                    .setCursorPosition(Coord2i{ LEVEL_COLS + 10, lineY })
+                    .put(line);
 
-            ++lineY;
+                ++lineY;
+            }
         }
 
         ++lineY;
-        g_game.getRenderer()
+        game.getRenderer()
             .setCursorPosition(Coord2i{ LEVEL_COLS + 10, lineY })
             .put("Press '-' to unload one.");
 
         char chToLoad;
         while (true) {
-            chToLoad = g_game.getReader().readChar();
+            chToLoad = game.getReader().readChar();
             if (chToLoad == '\033')
                 return;
             if (chToLoad == '-' or inventory.hasID(chToLoad))
@@ -501,79 +523,67 @@ void Hero::reloadWeapon() {
             auto bullet = weapon->cartridge.unloadOne();
             if (bullet) {
                 inventory.add(std::move(bullet)).doIf<AddStatus::AddError>([&] (auto & err) {
-                    g_game.drop(std::move(bullet), pos);
+                    game.drop(std::move(bullet), pos);
                 });
             }
         } else {
             auto & item = inventory[chToLoad];
             if (item.getType() == Item::Type::Ammo) {
                 if (weapon->cartridge.isFull()) {
-                    g_game.addMessage("Weapon is loaded");
+                    game.addMessage("Weapon is loaded");
                     return;
                 }
 
-                Ptr<Ammo> bullet;
-                if (item.count == 1) {
-                    auto itemptr = inventory.remove(item.inventorySymbol).release();
-                    bullet.reset(dynamic_cast<Ammo *>(itemptr));
-                } else {
-                    bullet = std::make_unique<Ammo>(dynamic_cast<Ammo &>(item));
-                    bullet->count = 1;
-                    --item.count;
-                }
-                weapon->cartridge.load(std::move(bullet));
+                weapon->cartridge.load(*game.getData().getAmmoTypes().at(item.getTypeID()));
+                inventory.consume(chToLoad);
             }
         }
     }
 }
 
-void Hero::showInventory() {
-    g_game.skipUpdate();
+void Hero::showInventory(Game & game) {
+    game.skipUpdate();
     if (inventory.isEmpty()) {
-        g_game.addMessage("Your inventory is empty");
+        game.addMessage("Your inventory is empty");
         return;
     }
     std::vector<Item const *> list;
     for (auto const & entry : inventory)
         list.push_back(entry.second);
 
-    std::sort(list.begin(), list.end(), [] (Item const * a, Item const * b) {
-        return a->inventorySymbol < b->inventorySymbol;
-    });
-
-    printList("Here is your inventory.", list,
+    printList(game, "Here is your inventory.", list,
             formatters::LetterNumberingByInventoryID{},
             formatters::DontMark{},
             formatters::WithEquippedStatus{ weapon, armor });
-    g_game.getReader().readChar();
+    game.getReader().readChar();
 }
 
-void Hero::wearArmor() {
-    auto [status, choice] = selectOneFromInventory("What do you want to wear?");
+void Hero::wearArmor(Game & game) {
+    auto [status, choice] = selectOneFromInventory(game, "What do you want to wear?");
     switch (status) {
         case NothingToSelect:
-            g_game.addMessage("You don't have anything to wear.");
-            g_game.skipUpdate();
+            game.addMessage("You don't have anything to wear.");
+            game.skipUpdate();
             return;
         case Cancelled:
-            g_game.skipUpdate();
+            game.skipUpdate();
             return;
         default:break;
     }
     auto & item = inventory[choice];
-    g_game.addMessage(format("Now you wearing {}.", item.getName()));
+    game.addMessage(format("Now you wearing {}.", game.getItemName(item)));
     armor = dynamic_cast<Armor *>(&item);
 }
 
-void Hero::dropItems() {
-    auto [status, choice] = selectOneFromInventory("What do you want to drop?");
+void Hero::dropItems(Game & game) {
+    auto [status, choice] = selectOneFromInventory(game, "What do you want to drop?");
     switch (status) {
         case NothingToSelect:
-            g_game.addMessage("You don't have anything to drop.");
-            g_game.skipUpdate();
+            game.addMessage("You don't have anything to drop.");
+            game.skipUpdate();
             return;
         case Cancelled:
-            g_game.skipUpdate();
+            game.skipUpdate();
             return;
         default:break;
     }
@@ -586,56 +596,54 @@ void Hero::dropItems() {
     auto & item = inventory[choice];
     int dropCount = 1;
     if (item.count != 1) {
-        clearRightPane();
+        clearRightPane(game);
         int maxCount = std::min(item.count, 9);
-        g_game.getRenderer()
+        game.getRenderer()
             .setCursorPosition(Coord2i{ LEVEL_COLS + 10, 0 })
             .put(format("How much items do you want to drop? [1-{}]", maxCount))
             .display();
 
-        dropCount = clamp(1, g_game.getReader().readChar() - '0', item.count);
+        dropCount = clamp(1, game.getReader().readChar() - '0', item.count);
     }
-    g_game.drop(item.splitStack(dropCount), pos);
-    if (item.count == 0)
-        inventory.remove(choice);
+    game.drop(inventory.split(choice, dropCount), pos);
 
     if (getInventoryItemsWeight() <= maxBurden and isBurdened) {
-        g_game.addMessage("You are burdened no more.");
+        game.addMessage("You are burdened no more.");
         isBurdened = false;
     }
 }
 
-void Hero::wieldWeapon() {
-    auto [status, itemID] = selectOneFromInventory("What do you want to wield?", [] (Item const & item) {
+void Hero::wieldWeapon(Game & game) {
+    auto [status, itemID] = selectOneFromInventory(game, "What do you want to wield?", [] (Item const & item) {
         return item.getType() == Item::Type::Weapon;
     });
     switch (status) {
         case NothingToSelect:
-            g_game.addMessage("You don't have anything to wield.");
-            g_game.skipUpdate();
+            game.addMessage("You don't have anything to wield.");
+            game.skipUpdate();
             return;
         case Success: {
             auto & item = inventory[itemID];
-            g_game.addMessage(format("You wield {}.", item.getName()));
+            game.addMessage(format("You wield {}.", game.getItemName(item)));
             weapon = dynamic_cast<Weapon *>(&item);
             break;
         }
         case Cancelled:
-            g_game.skipUpdate();
+            game.skipUpdate();
             break;
         default:break;
     }
 }
 
-void Hero::throwItem() {
-    auto [status, itemID] = selectOneFromInventory("What do you want to throw?");
+void Hero::throwItem(Game & game) {
+    auto [status, itemID] = selectOneFromInventory(game, "What do you want to throw?");
     switch (status) {
         case NothingToSelect:
-            g_game.addMessage("You don't have anything to throw.");
-            g_game.skipUpdate();
+            game.addMessage("You don't have anything to throw.");
+            game.skipUpdate();
             return;
         case Cancelled:
-            g_game.skipUpdate();
+            game.skipUpdate();
             return;
         default:
             break;
@@ -643,14 +651,14 @@ void Hero::throwItem() {
     auto & item = inventory[itemID];
     int throwCount = 1;
     if (item.count > 1) {
-        clearRightPane();
+        clearRightPane(game);
         int maxCount = std::min(item.count, 9);
-        g_game.getRenderer()
+        game.getRenderer()
                 .setCursorPosition(Coord2i{ LEVEL_COLS + 10, 0 })
                 .put(format("How many items do you want to throw? [1-{}]", maxCount));
 
         while (true) {
-            char countChoice = g_game.getReader().readChar();
+            char countChoice = game.getReader().readChar();
             if (countChoice == '\033')
                 return;
 
@@ -660,14 +668,14 @@ void Hero::throwItem() {
         }
     }
 
-    clearRightPane();
-    g_game.getRenderer()
+    clearRightPane(game);
+    game.getRenderer()
         .setCursorPosition(Coord2i{ LEVEL_COLS + 10, 0 })
         .put("In what direction?");
 
     Direction throwDir;
     while (true) {
-        char dirChoice = g_game.getReader().readChar();
+        char dirChoice = game.getReader().readChar();
         if (dirChoice == '\033')
             return;
 
@@ -683,80 +691,71 @@ void Hero::throwItem() {
     else if (weapon != nullptr and item.inventorySymbol == weapon->inventorySymbol)
         unequipWeapon();
 
-    auto itemToThrow = item.splitStack(throwCount);
-    if (item.count == 0)
-        inventory.remove(itemID);
+    auto itemToThrow = inventory.split(itemID, throwCount);
 
-    throwAnimated(std::move(itemToThrow), throwDir);
+    throwAnimated(game, std::move(itemToThrow), throwDir);
 }
 
-void Hero::drinkPotion() {
-    auto [status, itemID] = selectOneFromInventory("What do you want to drink?", [] (Item const & item) {
+void Hero::drinkPotion(Game & game) {
+    auto [status, itemID] = selectOneFromInventory(game, "What do you want to drink?", [] (Item const & item) {
         return item.getType() == Item::Type::Potion;
     });
     switch (status) {
         case NothingToSelect:
-            g_game.addMessage("You don't have anything to drink.");
-            g_game.skipUpdate();
+            game.addMessage("You don't have anything to drink.");
+            game.skipUpdate();
             return;
         case Cancelled:
-            g_game.skipUpdate();
+            game.skipUpdate();
             return;
         default:break;
     }
 
     auto & item = inventory[itemID];
     auto & potion = dynamic_cast<Potion &>(item);
-    switch (potion.effect) {
+    switch (game.getPotionEffect(potion.getTypeID())) {
         case Potion::Heal:
             heal(3);
-            g_game.addMessage("Now you feeling better.");
+            game.addMessage("Now you feeling better.");
             break;
         case Potion::Invisibility:
             turnsInvisible = 150;
-            g_game.addMessage("Am I invisible? Oh, lol!");
+            game.addMessage("Am I invisible? Oh, lol!");
             break;
-        case Potion::Teleport:
-            while (true) {
-                Coord2i pos = { Random::get(0, LEVEL_COLS - 1), Random::get(0, LEVEL_ROWS - 1) };
-                if (g_game.level()[pos] != 2 and not g_game.getUnitsMap()[pos]) {
-                    setTo(pos);
-                    break;
-                }
-            }
-            g_game.addMessage("Teleportation is so straaange thing!");
+        case Potion::Teleport: {
+            auto const & freeCells = game.getCurrentLevel().freeCells;
+            if (not freeCells.isEmpty())
+                setTo(game.getCurrentLevel(), freeCells[Random::get(0, freeCells.size() - 1)]);
+            game.addMessage("Teleportation is so straaange thing!");
             break;
+        }
         case Potion::None:
-            g_game.addMessage("Well.. You didn't die. Nice.");
+            game.addMessage("Well.. You didn't die. Nice.");
             break;
         case Potion::Blindness:
             vision = 1;
             turnsBlind = 50;
-            g_game.addMessage("My eyes!!");
+            game.addMessage("My eyes!!");
             break;
         default:
             throw std::logic_error("Unknown potion id");
     }
-    g_game.markPotionAsKnown(potion.id);
+    game.markPotionAsKnown(potion.getTypeID());
 
-    if (item.count == 1) {
-        inventory.remove(itemID);
-    } else {
-        --item.count;
-    }
+    inventory.consume(itemID);
 }
 
-void Hero::readScroll() {
-    auto [status, itemID] = selectOneFromInventory("What do you want to read?", [] (Item const & item) {
+void Hero::readScroll(Game & game) {
+    auto [status, itemID] = selectOneFromInventory(game, "What do you want to read?", [] (Item const & item) {
         return item.getType() == Item::Type::Scroll;
     });
     switch (status) {
         case NothingToSelect:
-            g_game.addMessage("You don't have anything to read.");
-            g_game.skipUpdate();
+            game.addMessage("You don't have anything to read.");
+            game.skipUpdate();
             return;
         case Cancelled:
-            g_game.skipUpdate();
+            game.skipUpdate();
             return;
         default:
             break;
@@ -765,12 +764,12 @@ void Hero::readScroll() {
     auto & item = inventory[itemID];
     switch (dynamic_cast<Scroll &>(item).effect) {
         case Scroll::Map:
-            g_game.addMessage("You wrote this map. Why you read it, I don't know.");
+            game.addMessage("You wrote this map. Why you read it, I don't know.");
             break;
         case Scroll::Identify: {
-            auto [status, chToApply] = selectOneFromInventory("What do you want to identify?", [] (Item const & item) {
+            auto [status, chToApply] = selectOneFromInventory(game, "What do you want to identify?", [&game] (Item const & item) {
                 if (item.getType() == Item::Type::Potion) {
-                    if (not g_game.isPotionKnown(item.id))
+                    if (not game.isPotionKnown(item.getTypeID()))
                         return true;
                 } else if (not item.showMdf){
                     return true;
@@ -779,11 +778,11 @@ void Hero::readScroll() {
             });
             switch (status) {
                 case NothingToSelect:
-                    g_game.addMessage("You have nothing to identify.");
-                    g_game.skipUpdate();
+                    game.addMessage("You have nothing to identify.");
+                    game.skipUpdate();
                     return;
                 case Cancelled:
-                    g_game.skipUpdate();
+                    game.skipUpdate();
                     return;
                 default:
                     break;
@@ -791,16 +790,12 @@ void Hero::readScroll() {
 
             auto & item2 = inventory[chToApply];
             if (item2.getType() == Item::Type::Potion) {
-                g_game.markPotionAsKnown(item2.id);
+                game.markPotionAsKnown(item2.getTypeID());
             } else {
                 item2.showMdf = true;
             }
 
-            if (item.count == 1) {
-                inventory.remove(itemID);
-            } else {
-                --item.count;
-            }
+            inventory.consume(itemID);
             break;
         }
         default:
@@ -808,68 +803,63 @@ void Hero::readScroll() {
     }
 }
 
-void Hero::attackEnemy(Coord2i cell) {
-    auto & unitsMap = g_game.getUnitsMap();
-    auto & enemy = dynamic_cast<Enemy &>(*unitsMap[cell]);
+void Hero::attackEnemy(Game & game, Coord2i cell) {
+    auto & enemy = dynamic_cast<Enemy &>(*game.getUnitsMap()[cell]);
     if (weapon) {
         enemy.dealDamage(weapon->damage);
     }
     if (enemy.health <= 0) {
-        enemy.dropInventory();
+        enemy.dropInventory(game.getCurrentLevel());
         xp += enemy.xpCost;
-        unitsMap[cell].reset();
+        game.getCurrentLevel().removeUnit(cell);
     }
 }
 
-void Hero::throwAnimated(Ptr<Item> item, Direction direction) {
-    int throwDist = 0;
+void Hero::throwAnimated(Game & game, Ptr<Item> item, Direction direction) {
     auto offset = toVec2i(direction);
     char sym = toChar(direction);
-    for (int i = 0; i < 12 - item->getTotalWeight() / 3; i++) {                        // 12 is "strength"
-        auto cell = pos + offset * (i + 1);
-
-        if (g_game.level()[cell] == 2)
-            break;
-
-        auto & unitsMap = g_game.getUnitsMap();
+    int throwLength = 12 - item->getTotalWeight() / 3;                                  // 12 is "strength"
+    auto const & level = game.getCurrentLevel();
+    int throwDist = los::traceProjectile(level.tiles, level.tileTypes, pos, offset, throwLength + 1, [&] (Coord2i cell, int) {
+        auto const & unitsMap = game.getUnitsMap();
         if (unitsMap[cell]) {
             unitsMap[cell]->dealDamage(item->getTotalWeight() / 2);
             if (unitsMap[cell]->health <= 0) {
                 auto & enemy = dynamic_cast<Enemy &>(*unitsMap[cell]);
-                enemy.dropInventory();
+                enemy.dropInventory(game.getCurrentLevel());
                 xp += enemy.xpCost;
-                unitsMap[cell].reset();
+                game.getCurrentLevel().removeUnit(cell);
             }
-            break;
+            return false;
         }
-        g_game.getRenderer()
+        game.getRenderer()
             .setCursorPosition(cell)
             .put(sym)
             .display();
-        throwDist++;
-        sleep(DELAY);
-    }
-    g_game.drop(std::move(item), pos + offset * throwDist);
+        game.pauseAnimation(DELAY);
+        return true;
+    });
+    game.drop(std::move(item), pos + offset * throwDist);
 }
 
-void Hero::shoot() {
+void Hero::shoot(Game & game) {
     if (weapon == nullptr or not weapon->isRanged) {
-        g_game.addMessage("You have no ranged weapon in hands.");
+        game.addMessage("You have no ranged weapon in hands.");
         return;
     }
     if (weapon->cartridge.isEmpty()) {
-        g_game.addMessage("You have no bullets.");
-        g_game.skipUpdate();
+        game.addMessage("You have no bullets.");
+        game.skipUpdate();
         return;
     }
-    g_game.getRenderer()
+    game.getRenderer()
         .setCursorPosition(Coord2i{ LEVEL_COLS + 10, 0 })
         .put("In what direction? ");
 
-    char choice = g_game.getReader().readChar();
+    char choice = game.getReader().readChar();
     auto optdir = getDirectionByControl(choice);
     if (not optdir) {
-        g_game.skipUpdate();
+        game.skipUpdate();
         return;
     }
     auto direction = *optdir;
@@ -877,54 +867,55 @@ void Hero::shoot() {
     char sym = toChar(direction);
     int bulletPower = weapon->cartridge.next().damage + weapon->damageBonus;
 
-    for (int i = 1; i < weapon->range + weapon->cartridge.next().range; i++) {
-        auto cell = pos + offset * i;
-
-        if (g_game.level()[cell] == 2)
-            break;
-
-        auto & unitsMap = g_game.getUnitsMap();
+    int flightLength = weapon->range + weapon->cartridge.next().range;
+    auto const & level = game.getCurrentLevel();
+    los::traceProjectile(level.tiles, level.tileTypes, pos, offset, flightLength, [&] (Coord2i cell, int i) {
+        auto const & unitsMap = game.getUnitsMap();
         if (unitsMap[cell]) {
             unitsMap[cell]->dealDamage(bulletPower - i / 3);
             if (unitsMap[cell]->health <= 0) {
                 auto & enemy = dynamic_cast<Enemy &>(*unitsMap[cell]);
-                enemy.dropInventory();
+                enemy.dropInventory(game.getCurrentLevel());
                 xp += enemy.xpCost;
-                unitsMap[cell].reset();
+                game.getCurrentLevel().removeUnit(cell);
             }
         }
-        g_game.getRenderer()
+        game.getRenderer()
             .setCursorPosition(cell)
             .put(sym)
             .display();
-        sleep(DELAY / 3);
-    }
-    weapon->cartridge.unloadOne();
+        game.pauseAnimation(DELAY / 3);
+        return true;
+    });
+    weapon->cartridge.fireOne();
 }
 
-void Hero::moveTo(Coord2i cell) {
-    auto const & level = g_game.level();
+void Hero::moveTo(Game & game, Coord2i cell) {
+    auto const & level = game.level();
+    auto const & tileTypes = game.getData().getTileTypes();
     if (not level.isIndex(cell))
         return;
-    if (level[cell] != 2 or canMoveThroughWalls) {
-        auto const & unitsMap = g_game.getUnitsMap();
+    if (tileTypes.isWalkable(level[cell]) or canMoveThroughWalls) {
+        auto const & unitsMap = game.getUnitsMap();
         if (unitsMap[cell] and unitsMap[cell]->getType() == Unit::Type::Enemy) {
-            attackEnemy(cell);
+            attackEnemy(game, cell);
         } else if (not unitsMap[cell]) {
-            setTo(cell);
+            setTo(game.getCurrentLevel(), cell);
         }
-    } else if (level[cell] == 2) {
-        if (weapon != nullptr and weapon->canDig) {
-            g_game.getRenderer()
+    } else {
+        auto const & tileName = tileTypes.at(level[cell]).name;
+        if (tileTypes.isDiggable(level[cell]) and weapon != nullptr and weapon->canDig) {
+            game.getRenderer()
                 .setCursorPosition(Coord2i{ LEVEL_COLS + 10, 0 })
-                .put("Do you want to dig this wall? [yn]");
+                .put(format("Do you want to dig this {}? [yn]", tileName));
 
-            char inpChar = g_game.getReader().readChar();
+            char inpChar = game.getReader().readChar();
             if (inpChar == 'y' or inpChar == 'Y') {
-                g_game.level()[cell] = 1;
+                game.getCurrentLevel().setTile(cell, tile::FLOOR);
+                game.markLevelChanged();
                 float breakProbability = (Hero::MAX_LUCK - luck) / 100.f;
                 if (Random::get<bool>(breakProbability)) {
-                    g_game.addMessage(format("You've broken your {}.", weapon->getName()));
+                    game.addMessage(format("You've broken your {}.", game.getItemName(*weapon)));
                     char weaponID = weapon->inventorySymbol;
                     unequipWeapon();
                     inventory.remove(weaponID);
@@ -932,8 +923,8 @@ void Hero::moveTo(Coord2i cell) {
                 return;
             }
         }
-        g_game.addMessage("The wall is the way.");
-        g_game.skipUpdate();
+        game.addMessage(format("The {} is in the way.", tileName));
+        game.skipUpdate();
     }
 }
 
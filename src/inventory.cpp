@@ -4,95 +4,221 @@
 
 #include<stdexcept>
 #include<algorithm>
+#include<cassert>
 
-Inventory::Inventory(Inventory const & other) {
-    for (auto const & item : other.items) {
-        items.emplace(item.first, item.second->cloneItem());
+Inventory::Inventory()
+    : storage(std::make_shared<Storage>()) {}
+
+std::shared_ptr<Inventory::Storage> Inventory::Storage::clone() const {
+    auto copy = std::make_shared<Storage>();
+    for (int slot = 0; slot < inventory_slots::COUNT; ++slot) {
+        if (slots[slot])
+            copy->slots[slot] = slots[slot]->cloneItem();
+    }
+    copy->occupied = occupied;
+    copy->stacks = stacks;
+    copy->totalWeight = totalWeight;
+    copy->categoryCounts = categoryCounts;
+    copy->typeCounts = typeCounts;
+    return copy;
+}
+
+bool Inventory::detach() {
+    if (not isShared())
+        return false;
+    storage = storage->clone();
+    return true;
+}
+
+Inventory::Storage & Inventory::own() {
+    // the shared items may be a prototype's, used by every game on every thread
+    if (isShared())
+        throw std::logic_error("Changing an inventory that shares its items, it has to be detached first");
+    return *storage;
+}
+
+char Inventory::place(Ptr<Item> item, int slot) {
+    auto & data = own();
+    char symbol = inventory_slots::toSymbol(slot);
+    item->inventorySymbol = symbol;
+    if (item->isStackable() and findStack(item->getTypeID()) == -1)
+        data.stacks.emplace_back(item->getTypeID(), slot);
+    account(*item, item->count);
+    data.slots[slot] = std::move(item);
+    data.occupied |= inventory_slots::bit(slot);
+    checkAggregates();
+    return symbol;
+}
+
+Ptr<Item> Inventory::take(int slot) {
+    auto & data = own();
+    auto item = std::move(data.slots[slot]);
+    data.occupied &= ~inventory_slots::bit(slot);
+
+    auto stack = std::find_if(data.stacks.begin(), data.stacks.end(), [slot] (auto const & entry) {
+        return entry.second == slot;
+    });
+    if (stack != data.stacks.end()) {
+        // another slot may hold the same item, e.g. if it was put there by symbol
+        data.stacks.erase(stack);
+        for (auto const & [symbol, other] : std::as_const(*this)) {
+            if (other->getTypeID() == item->getTypeID()) {
+                data.stacks.emplace_back(item->getTypeID(), inventory_slots::toSlot(symbol));
+                break;
+            }
+        }
+    }
+
+    account(*item, -item->count);
+    checkAggregates();
+    item->inventorySymbol = 0;
+    return item;
+}
+
+void Inventory::account(Item const & item, int count) {
+    auto & data = own();
+    data.totalWeight += item.getSingleWeight() * count;
+    data.categoryCounts[static_cast<int>(item.getType())] += count;
+
+    int typeIndex = item.getTypeID().value;
+    if (data.typeCounts.size() <= typeIndex)
+        data.typeCounts.resize(typeIndex + 1);
+    data.typeCounts[typeIndex] += count;
+}
+
+void Inventory::checkAggregates() const {
+#ifndef NDEBUG
+    int expectedWeight = 0;
+    std::array<int, Item::TYPE_COUNT> expectedCategoryCounts{};
+    std::vector<int> expectedTypeCounts(storage->typeCounts.size());
+    for (auto const & [symbol, item] : *this) {
+        expectedWeight += item->getTotalWeight();
+        expectedCategoryCounts[static_cast<int>(item->getType())] += item->count;
+        assert(item->getTypeID().value < expectedTypeCounts.size());
+        expectedTypeCounts[item->getTypeID().value] += item->count;
     }
+    assert(storage->totalWeight == expectedWeight);
+    assert(storage->categoryCounts == expectedCategoryCounts);
+    assert(storage->typeCounts == expectedTypeCounts);
+#endif
+}
+
+int Inventory::countOf(TypeID typeID) const {
+    if (not typeID.isValid() or typeID.value >= storage->typeCounts.size())
+        return 0;
+    return storage->typeCounts[typeID.value];
 }
 
-Inventory & Inventory::operator=(Inventory const & other) {
-    items.clear();
-    for (auto const & item : other.items) {
-        items.emplace(item.first, item.second->cloneItem());
+bool Inventory::consume(char id, int count) {
+    auto & item = (*this)[id];
+    if (count <= 0 or count > item.count)
+        throw std::logic_error("Trying to consume more items than there are in the stack");
+    if (count == item.count) {
+        remove(id);
+        return false;
     }
-    return *this;
+    item.count -= count;
+    account(item, -count);
+    checkAggregates();
+    return true;
+}
+
+Ptr<Item> Inventory::split(char id, int count) {
+    auto & item = (*this)[id];
+    if (count == item.count)
+        return remove(id);
+
+    auto part = item.splitStack(count);
+    account(item, -count);
+    checkAggregates();
+    return part;
+}
+
+int Inventory::findStack(TypeID typeID) const {
+    for (auto const & [stackID, slot] : storage->stacks)
+        if (stackID == typeID)
+            return slot;
+    return -1;
 }
 
 Ptr<Item> Inventory::remove(char id) {
-    auto iter = items.find(id);
-    if (iter == items.end()) {
+    int slot = inventory_slots::toSlot(id);
+    if (slot == -1 or not storage->slots[slot]) {
         throw std::logic_error("Trying to remove an item that doesn't exist");
     }
-    auto item = std::move(iter->second);
-    items.erase(iter);
-    item->inventorySymbol = 0;
-    return item;
+    return take(slot);
 }
 
 int Inventory::size() const {
-    return items.size();
+    return __builtin_popcountll(storage->occupied);
 }
 
 bool Inventory::isFull() const {
-    return size() == 52;
+    return storage->occupied == inventory_slots::ALL;
 }
 
 bool Inventory::isEmpty() const {
-    return items.empty();
+    return storage->occupied == 0;
 }
 
 bool Inventory::hasID(char id) const {
-    return items.count(id) == 1;
+    int slot = inventory_slots::toSlot(id);
+    return slot != -1 and storage->slots[slot] != nullptr;
 }
 
 Item & Inventory::operator [](char id) {
-    auto iter = find(id);
-    if (iter == end())
+    if (not hasID(id))
         throw std::logic_error("Trying to get an item that doesn't exist");
-    //auto & t = *iter->second;
-    return *iter->second;
+    return *own().slots[inventory_slots::toSlot(id)];
 }
 
 Item const & Inventory::operator [](char id) const {
-    auto iter = find(id);
-    if (iter == cend())
+    if (not hasID(id))
         throw std::logic_error("Trying to get an item that doesn't exist");
-    return *iter->second;
+    return *storage->slots[inventory_slots::toSlot(id)];
 }
 
 InventoryIterator Inventory::find(char id) {
-    return InventoryIterator(items.find(id));
+    if (not hasID(id))
+        return end();
+    auto & data = own();
+    return InventoryIterator(data.slots.data(), data.occupied & ~(inventory_slots::bit(inventory_slots::toSlot(id)) - 1));
 }
 
 ConstInventoryIterator Inventory::find(char id) const {
-    return ConstInventoryIterator(items.find(id));
+    if (not hasID(id))
+        return end();
+    return ConstInventoryIterator(storage->slots.data(), storage->occupied & ~(inventory_slots::bit(inventory_slots::toSlot(id)) - 1));
 }
 
 InventoryIterator Inventory::begin() {
-    return InventoryIterator(items.begin());
+    auto & data = own();
+    return InventoryIterator(data.slots.data(), data.occupied);
 }
 
 ConstInventoryIterator Inventory::begin() const {
-    return ConstInventoryIterator(items.begin());
+    return ConstInventoryIterator(storage->slots.data(), storage->occupied);
 }
 
 ConstInventoryIterator Inventory::cbegin() const {
-    return ConstInventoryIterator(items.begin());
+    return ConstInventoryIterator(storage->slots.data(), storage->occupied);
 }
 
 InventoryIterator Inventory::end() {
-    return InventoryIterator(items.end());
+    return InventoryIterator(own().slots.data(), 0);
 }
 
 ConstInventoryIterator Inventory::end() const {
-    return ConstInventoryIterator(items.end());
+    return ConstInventoryIterator(storage->slots.data(), 0);
 }
 
 ConstInventoryIterator Inventory::cend() const {
-    return ConstInventoryIterator(items.end());
+    return ConstInventoryIterator(storage->slots.data(), 0);
 }
 
 InventoryIterator Inventory::erase(ConstInventoryIterator iter) {
-    return InventoryIterator(items.erase(iter.iter));
+    int slot = iter.slot();
+    std::uint64_t rest = iter.remaining & (iter.remaining - 1);
+    take(slot);
+    return InventoryIterator(storage->slots.data(), rest);
 }
@@ -14,7 +14,7 @@ std::string Item::getMdf() const {
 }
 
 std::string Item::getName() const {
-    return name;
+    return typeInfo->name;
 }
 
 Ptr<Item> Item::splitStack(int toSplit) {
@@ -28,10 +28,10 @@ Ptr<Item> Item::splitStack(int toSplit) {
 }
 
 int Item::getSingleWeight() const {
-    return weight;
+    return typeInfo->weight;
 }
 
 int Item::getTotalWeight() const {
-    return weight * count;
+    return typeInfo->weight * count;
 }
 
@@ -0,0 +1,58 @@
+#include<item_piles.hpp>
+
+#include<items/item.hpp>
+
+#include<stdexcept>
+
+int ItemPiles::count(Coord2i cell) const {
+    if (not hasItems(cell))
+        return 0;
+    return static_cast<int>(piles.at(toIndex(cell)).size());
+}
+
+ItemPile const & ItemPiles::operator [](Coord2i cell) const {
+    static ItemPile const empty;
+    if (not hasItems(cell))
+        return empty;
+    return piles.at(toIndex(cell));
+}
+
+Ptr<Item> & ItemPiles::at(Coord2i cell, int index) {
+    if (not hasItems(cell))
+        throw std::logic_error("Trying to get an item from an empty cell");
+    return piles.at(toIndex(cell)).at(index);
+}
+
+void ItemPiles::add(Coord2i cell, Ptr<Item> item) {
+    int index = toIndex(cell);
+    piles[index].push_back(std::move(item));
+    occupied[index] = true;
+}
+
+void ItemPiles::erase(Coord2i cell, std::vector<int> const & indices) {
+    if (indices.empty())
+        return;
+
+    int index = toIndex(cell);
+    auto & pile = piles.at(index);
+    int kept = 0;
+    auto toErase = indices.begin();
+    for (int i = 0; i < pile.size(); ++i) {
+        if (toErase != indices.end() and *toErase == i) {
+            ++toErase;
+            continue;
+        }
+        pile[kept++] = std::move(pile[i]);
+    }
+    pile.resize(kept);
+
+    if (pile.empty()) {
+        piles.erase(index);
+        occupied[index] = false;
+    }
+}
+
+void ItemPiles::clear() {
+    piles.clear();
+    occupied.reset();
+}
@@ -0,0 +1,222 @@
+#include<level_factory.hpp>
+
+#include<game_data.hpp>
+#include<gen_caves.hpp>
+#include<gen_map.hpp>
+#include<level_file.hpp>
+#include<items/item.hpp>
+#include<units/enemy.hpp>
+
+#include<fmt/format.h>
+
+#include<algorithm>
+#include<stdexcept>
+
+namespace {
+    // the level must have a free cell
+    Coord2i randomFreeCell(DungeonLevel const & level, LevelRandom & random) {
+        auto const & freeCells = level.freeCells;
+        return freeCells[random.below(freeCells.size())];
+    }
+}
+
+LevelFactory::~LevelFactory() {
+    {
+        std::lock_guard lock(jobsMutex);
+        stopping = true;
+    }
+    jobsChanged.notify_one();
+    if (worker.joinable())
+        worker.join();
+}
+
+Ptr<DungeonLevel> LevelFactory::build(int depth, int heroLuck, std::uint64_t seed) const {
+    auto level = std::make_unique<DungeonLevel>(data.getTileTypes());
+    level->depth = depth;
+
+    LevelRandom random(seed);
+    switch (generator) {
+        case LevelGenerator::Maze:
+            gen::generateMaze(level->tiles, random);
+            break;
+        case LevelGenerator::Caves:
+            gen::generateCaves(level->tiles, random);
+            break;
+    }
+    level->indexFreeCells();
+    populate(*level, heroLuck, random);
+    return level;
+}
+
+Ptr<DungeonLevel> LevelFactory::build(LevelFile const & file, int depth, int heroLuck, std::uint64_t seed) const {
+    auto level = std::make_unique<DungeonLevel>(data.getTileTypes());
+    level->depth = depth;
+    file.copyTiles(level->tiles);
+    level->indexFreeCells();
+
+    LevelRandom random(seed);
+    if (file.getSpawns().empty()) {
+        populate(*level, heroLuck, random);
+    } else {
+        // the stairs go where nothing was placed by hand
+        placeSpawns(*level, file);
+        placeStairs(*level, random);
+    }
+    return level;
+}
+
+void LevelFactory::prepare(int depth, int heroLuck, std::uint64_t seed) {
+    if (next.valid() and preparedDepth == depth and preparedSeed == seed)
+        return;
+
+    Job job([this, depth, heroLuck, seed] {
+        return build(depth, heroLuck, seed);
+    });
+    if (next.valid()) {
+        // queued after the build of that level, so the worker doesn't wait on itself
+        push(Job([dropped = std::move(next)] () mutable {
+            dropped.get();
+            return Ptr<DungeonLevel>{};
+        }));
+    }
+    next = job.get_future();
+    preparedDepth = depth;
+    preparedSeed = seed;
+    push(std::move(job));
+}
+
+Ptr<DungeonLevel> LevelFactory::restore(PackedFloor packed) {
+    Job job([this, packed = std::move(packed)] {
+        return unpackFloor(packed, data);
+    });
+    auto restored = job.get_future();
+    push(std::move(job));
+    return restored.get();
+}
+
+void LevelFactory::retire(Ptr<DungeonLevel> level) {
+    if (not level)
+        return;
+    push(Job([level = std::move(level)] () mutable {
+        level.reset();
+        return Ptr<DungeonLevel>{};
+    }));
+}
+
+Ptr<DungeonLevel> LevelFactory::take() {
+    if (not next.valid())
+        throw std::logic_error("Trying to take a level that wasn't prepared");
+    return next.get();
+}
+
+void LevelFactory::push(Job job) {
+    if (not background) {
+        job();
+        return;
+    }
+    {
+        std::lock_guard lock(jobsMutex);
+        jobs.push_back(std::move(job));
+        if (not worker.joinable())
+            worker = std::thread(&LevelFactory::work, this);
+    }
+    jobsChanged.notify_one();
+}
+
+void LevelFactory::work() {
+    std::unique_lock lock(jobsMutex);
+    while (true) {
+        jobsChanged.wait(lock, [this] { return stopping or not jobs.empty(); });
+        if (jobs.empty())
+            return;
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+void LevelFactory::populate(DungeonLevel & level, int heroLuck, LevelRandom & random) const {
+    placeStairs(level, random);
+    // taken out of the free cells for a while, so every draw lands on a cell an enemy may take
+    level.freeCells.remove(level.entrance);
+    spawnEnemies(level, random);
+    level.freeCells.add(level.entrance);
+    spawnItems(level, heroLuck, random);
+}
+
+void LevelFactory::placeStairs(DungeonLevel & level, LevelRandom & random) const {
+    if (level.freeCells.size() < 2)
+        throw std::logic_error("A level needs at least two floor cells for the stairs");
+    level.entrance = randomFreeCell(level, random);
+    level.freeCells.remove(level.entrance);
+    level.stairsDown = randomFreeCell(level, random);
+    level.freeCells.add(level.entrance);
+}
+
+void LevelFactory::placeSpawns(DungeonLevel & level, LevelFile const & file) const {
+    auto const & enemyTypes = data.getEnemyTypes();
+    for (auto const & spawn : file.getSpawns()) {
+        if (spawn.kind == LevelSpawn::Kind::Item) {
+            auto item = data.createItem(data.getItemTypeIDs().find(spawn.id));
+            if (not item)
+                throw std::logic_error(fmt::format("Unknown item '{}' in the level file", spawn.id));
+            if (spawn.count != 1 and not item->isStackable())
+                throw std::logic_error(fmt::format("'{}' in the level file doesn't stack", spawn.id));
+            item->count = spawn.count;
+            level.drop(std::move(item), spawn.cell);
+        } else {
+            TypeID typeID = data.getUnitTypeIDs().find(spawn.id);
+            if (not enemyTypes.count(typeID))
+                throw std::logic_error(fmt::format("Unknown enemy '{}' in the level file", spawn.id));
+            if (level.units[spawn.cell])
+                throw std::logic_error(fmt::format("Two enemies at {}:{} in the level file",
+                            spawn.cell.x, spawn.cell.y));
+            level.placeUnit(enemyTypes.at(typeID)->clone(), spawn.cell);
+        }
+    }
+}
+
+void LevelFactory::spawnEnemies(DungeonLevel & level, LevelRandom & random) const {
+    auto const & spawnTable = data.getEnemySpawnTable();
+    int enemyCount = spawnTable.rollCount(random);
+    for (int i = 0; i < enemyCount; i++) {
+        if (level.freeCells.isEmpty())
+            break;
+        Coord2i pos = randomFreeCell(level, random);
+
+        auto const * entry = spawnTable.pick(level.depth, random);
+        if (not entry)
+            break;
+        level.placeUnit(data.getEnemyTypes().at(entry->typeID)->clone(), pos);
+    }
+}
+
+void LevelFactory::spawnItems(DungeonLevel & level, int heroLuck, LevelRandom & random) const {
+    auto const & spawnTable = data.getItemSpawnTable();
+    int rolls = spawnTable.rollCount(random);
+    for (int i = 0; i < rolls; ++i) {
+        auto const * entry = spawnTable.pick(level.depth, random);
+        if (not entry)
+            break;
+
+        auto item = data.createItem(entry->typeID);
+        if (entry->count) {
+            item->count = random.between(entry->count->first, entry->count->second);
+        } else if (item->getType() == Item::Type::Ammo) {
+            item->count = random.between(1, std::max(heroLuck, 1));
+        }
+        if (item->getType() == Item::Type::Armor) {
+            float thornsProbability = heroLuck / 500.f;
+            if (random.chance(thornsProbability)) {
+                item->mdf = 2;
+            }
+        }
+
+        if (level.freeCells.isEmpty())
+            break;
+        level.drop(std::move(item), randomFreeCell(level, random));
+    }
+}
@@ -0,0 +1,143 @@
+#include<level_file.hpp>
+
+#include<fmt/format.h>
+
+#include<algorithm>
+#include<cstring>
+#include<stdexcept>
+
+namespace {
+    char const MAGIC[4] = { 'R', 'L', 'L', 'V' };
+    std::size_t const HEADER_SIZE = 20;
+    std::size_t const SPAWN_HEADER_SIZE = 8;
+
+    // bounds are checked by the caller
+    std::uint32_t readU32(std::uint8_t const * bytes) {
+        return std::uint32_t(bytes[0])
+            | std::uint32_t(bytes[1]) << 8
+            | std::uint32_t(bytes[2]) << 16
+            | std::uint32_t(bytes[3]) << 24;
+    }
+
+    std::uint16_t readU16(std::uint8_t const * bytes) {
+        return static_cast<std::uint16_t>(bytes[0] | bytes[1] << 8);
+    }
+
+    void writeU32(std::ostream & out, std::uint32_t value) {
+        char bytes[4] = {
+            static_cast<char>(value),
+            static_cast<char>(value >> 8),
+            static_cast<char>(value >> 16),
+            static_cast<char>(value >> 24)
+        };
+        out.write(bytes, sizeof(bytes));
+    }
+
+    void writeU16(std::ostream & out, std::uint16_t value) {
+        char bytes[2] = { static_cast<char>(value), static_cast<char>(value >> 8) };
+        out.write(bytes, sizeof(bytes));
+    }
+
+    void writeHeader(std::ostream & out, int rows, int cols, std::size_t spawnCount) {
+        if (rows <= 0 or cols <= 0 or rows > LevelFile::MAX_SIDE or cols > LevelFile::MAX_SIDE)
+            throw std::logic_error(fmt::format("A level file can't be {}x{}, its sides are 1 to {}",
+                        cols, rows, LevelFile::MAX_SIDE));
+        out.write(MAGIC, sizeof(MAGIC));
+        writeU32(out, LevelFile::VERSION);
+        writeU32(out, rows);
+        writeU32(out, cols);
+        writeU32(out, spawnCount);
+    }
+}
+
+LevelFile::LevelFile(std::string const & filename, TileTypes const & tileTypes): file(filename) {
+    auto fail = [&] (std::string_view what) {
+        return std::logic_error(fmt::format("Level file '{}' {}", filename, what));
+    };
+
+    std::uint8_t const * bytes = file.data();
+    std::size_t size = file.size();
+    if (size < HEADER_SIZE or std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0)
+        throw fail("is not a level file");
+    if (std::uint32_t version = readU32(bytes + 4); version != VERSION)
+        throw fail(fmt::format("has version {}, only {} is supported", version, VERSION));
+
+    std::uint32_t fileRows = readU32(bytes + 8);
+    std::uint32_t fileCols = readU32(bytes + 12);
+    std::uint32_t spawnCount = readU32(bytes + 16);
+    if (fileRows == 0 or fileCols == 0 or fileRows > MAX_SIDE or fileCols > MAX_SIDE)
+        throw fail(fmt::format("has a wrong size {}x{}", fileCols, fileRows));
+    rows = static_cast<int>(fileRows);
+    cols = static_cast<int>(fileCols);
+
+    std::size_t pos = HEADER_SIZE;
+    std::size_t tileCount = std::size_t(rows) * cols;
+    if (size - pos < tileCount)
+        throw fail("is cut short in the tiles");
+    tiles = bytes + pos;
+    for (std::size_t i = 0; i < tileCount; ++i)
+        if (not tileTypes.isDefined(tiles[i]))
+            throw fail(fmt::format("has an unknown tile {} at {}:{}", tiles[i], i % cols, i / cols));
+    pos += tileCount;
+
+    spawns.reserve(std::min<std::size_t>(spawnCount, (size - pos) / SPAWN_HEADER_SIZE));
+    for (std::uint32_t i = 0; i < spawnCount; ++i) {
+        if (size - pos < SPAWN_HEADER_SIZE)
+            throw fail("is cut short in the spawns");
+        std::uint8_t const * record = bytes + pos;
+        int kind = record[0];
+        std::size_t idLength = record[1];
+        int row = readU16(record + 2);
+        int col = readU16(record + 4);
+        int count = readU16(record + 6);
+        pos += SPAWN_HEADER_SIZE;
+        if (size - pos < idLength)
+            throw fail("is cut short in the spawns");
+
+        LevelSpawn spawn;
+        if (kind > static_cast<int>(LevelSpawn::Kind::Enemy))
+            throw fail(fmt::format("has an unknown spawn kind {}", kind));
+        spawn.kind = static_cast<LevelSpawn::Kind>(kind);
+        spawn.id = std::string_view(reinterpret_cast<char const *>(bytes + pos), idLength);
+        spawn.cell = Coord2i{ col, row };
+        spawn.count = count;
+        if (row >= rows or col >= cols or not tileTypes.isWalkable(tileAt(row, col)))
+            throw fail(fmt::format("spawns '{}' on a tile that isn't walkable at {}:{}", spawn.id, col, row));
+        if (count == 0)
+            throw fail(fmt::format("spawns no '{}' at {}:{}", spawn.id, col, row));
+        spawns.push_back(spawn);
+        pos += idLength;
+    }
+
+    if (pos != size)
+        throw fail("has extra bytes at the end");
+}
+
+void LevelFile::copyTiles(LevelData & level) const {
+    if (rows != LEVEL_ROWS or cols != LEVEL_COLS)
+        throw std::logic_error(fmt::format("A level must be {}x{}, the file is {}x{}",
+                    LEVEL_COLS, LEVEL_ROWS, cols, rows));
+    // both are a byte per tile, row by row
+    for (int r = 0; r < rows; ++r)
+        std::copy_n(tiles + std::size_t(r) * cols, cols, &level.at(r, 0));
+}
+
+void writeLevelFile(std::ostream & out, int rows, int cols, std::uint8_t const * tiles,
+        std::vector<LevelSpawn> const & spawns) {
+    writeHeader(out, rows, cols, spawns.size());
+    out.write(reinterpret_cast<char const *>(tiles), std::streamsize(rows) * cols);
+    for (auto const & spawn : spawns) {
+        if (spawn.id.size() > UINT8_MAX)
+            throw std::logic_error(fmt::format("Spawn id '{}' is too long for a level file", spawn.id));
+        out.put(static_cast<char>(spawn.kind));
+        out.put(static_cast<char>(spawn.id.size()));
+        writeU16(out, spawn.cell.y);
+        writeU16(out, spawn.cell.x);
+        writeU16(out, spawn.count);
+        out.write(spawn.id.data(), spawn.id.size());
+    }
+}
+
+void writeLevelHeader(std::ostream & out, int rows, int cols) {
+    writeHeader(out, rows, cols, 0);
+}
@@ -0,0 +1,18 @@
+#include<line_of_sight.hpp>
+
+bool los::isRayClear(LevelData const & level, TileTypes const & tileTypes, Vec2<long long> from, Vec2<long long> to) {
+    return walkRay(from.x, from.y, to.x, to.y, [&level, &tileTypes] (long long x, long long y) {
+        return not isOpaque(level, tileTypes, Coord2i{ int(x), int(y) });
+    });
+}
+
+bool los::isVisible(LevelData const & level, TileTypes const & tileTypes, Coord2i from, Coord2i to) {
+    Vec2<long long> center = Vec2<long long>{ from } * SCALE + SCALE / 2;
+    Vec2<long long> corner = Vec2<long long>{ to } * SCALE;
+    long long const nearEdge = SCALE / PRECISION;
+    long long const farEdge = SCALE - nearEdge;
+    return isRayClear(level, tileTypes, center, corner + Vec2<long long>{ nearEdge, nearEdge })
+        or isRayClear(level, tileTypes, center, corner + Vec2<long long>{ nearEdge, farEdge })
+        or isRayClear(level, tileTypes, center, corner + Vec2<long long>{ farEdge, nearEdge })
+        or isRayClear(level, tileTypes, center, corner + Vec2<long long>{ farEdge, farEdge });
+}
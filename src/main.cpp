@@ -41,7 +41,13 @@
 //!COMMENT! // Also it isn't needed to show to the player his satiation. And luck too. And other stuff.
 
 #include<game.hpp>
+#include<game_data.hpp>
+#include<termlib/default_window_provider.hpp>
 
 int main() {
-    g_game.run();
+    GameData data;
+    data.load();
+
+    Game game(data, DefaultWindowProvider::getWindow());
+    game.run();
 }
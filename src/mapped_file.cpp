@@ -0,0 +1,39 @@
+#include<mapped_file.hpp>
+
+#include<fmt/format.h>
+
+#include<stdexcept>
+
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+MappedFile::MappedFile(std::string const & filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::logic_error(fmt::format("Can't open '{}'", filename));
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::logic_error(fmt::format("Can't get the size of '{}'", filename));
+    }
+    length = static_cast<std::size_t>(info.st_size);
+
+    if (length > 0) {
+        address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            address = nullptr;
+            close(fd);
+            throw std::logic_error(fmt::format("Can't map '{}' into memory", filename));
+        }
+    }
+    // the mapping stays valid without the descriptor
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (address)
+        munmap(address, length);
+}
@@ -0,0 +1,177 @@
+#include<object_pool.hpp>
+
+#include<array>
+#include<atomic>
+#include<cstdint>
+#include<mutex>
+#include<new>
+#include<vector>
+
+namespace {
+    std::size_t const ALIGNMENT = alignof(std::max_align_t);
+    std::size_t const CLASS_COUNT = pool::MAX_POOLED_SIZE / ALIGNMENT;
+    // chunks are aligned to their size, so the chunk of a block is found from its address
+    std::size_t const CHUNK_SIZE = 64 * 1024;
+
+    struct FreeBlock {
+        FreeBlock * next;
+    };
+
+    struct ThreadPool;
+
+    // at the start of every chunk, the blocks follow it
+    struct alignas(ALIGNMENT) ChunkHeader {
+        ThreadPool * owner;
+    };
+
+    // the counters are read by getStats() on any thread, only the owner changes them
+    void bump(std::atomic<long long> & counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    //////////////////////////////////////////////////
+    // Only the thread the pool belongs to allocates from it and frees to its free lists.
+    // Other threads push the blocks they free on `remoteFrees`, which the owner takes
+    // all at once when the free list of that size class is empty.
+    struct ThreadPool {
+        std::array<FreeBlock *, CLASS_COUNT> freeLists{};
+        std::array<std::atomic<FreeBlock *>, CLASS_COUNT> remoteFrees{};
+        char * chunkPos = nullptr;
+        char * chunkEnd = nullptr;
+
+        std::atomic<long long> allocations{ 0 };
+        std::atomic<long long> reused{ 0 };
+        std::atomic<long long> remoteFreeCount{ 0 };
+        std::atomic<long long> chunks{ 0 };
+
+        void * allocate(std::size_t sizeClass) {
+            bump(allocations);
+            FreeBlock * block = freeLists[sizeClass];
+            if (not block and remoteFrees[sizeClass].load(std::memory_order_relaxed))
+                block = remoteFrees[sizeClass].exchange(nullptr, std::memory_order_acquire);
+            if (block) {
+                bump(reused);
+                freeLists[sizeClass] = block->next;
+                return block;
+            }
+
+            std::size_t blockSize = (sizeClass + 1) * ALIGNMENT;
+            if (chunkEnd - chunkPos < blockSize) {
+                // the rest of the old chunk is abandoned, it is smaller than MAX_POOLED_SIZE
+                char * chunk = static_cast<char *>(::operator new(CHUNK_SIZE, std::align_val_t{ CHUNK_SIZE }));
+                new (chunk) ChunkHeader{ this };
+                chunkPos = chunk + sizeof(ChunkHeader);
+                chunkEnd = chunk + CHUNK_SIZE;
+                bump(chunks);
+            }
+            void * result = chunkPos;
+            chunkPos += blockSize;
+            return result;
+        }
+
+        void deallocate(void * ptr, std::size_t sizeClass) {
+            auto * block = static_cast<FreeBlock *>(ptr);
+            block->next = freeLists[sizeClass];
+            freeLists[sizeClass] = block;
+        }
+
+        // from any thread, the owner only takes the whole list, so a pushed block can't come back under us
+        void deallocateRemote(void * ptr, std::size_t sizeClass) {
+            auto * block = static_cast<FreeBlock *>(ptr);
+            auto & head = remoteFrees[sizeClass];
+            block->next = head.load(std::memory_order_relaxed);
+            while (not head.compare_exchange_weak(block->next, block,
+                        std::memory_order_release, std::memory_order_relaxed)) {}
+            remoteFreeCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // Pools are never deleted, their blocks may outlive the thread and chunks point at them
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadPool *> pools;
+        std::vector<ThreadPool *> idle; // of the threads that ended
+    };
+
+    Registry & registry() {
+        // not destroyed at exit, objects freed by destructors of statics still find their pool
+        static Registry * instance = new Registry;
+        return *instance;
+    }
+
+    thread_local ThreadPool * threadPool = nullptr;
+
+    // hands the pool of a thread over to the next one when the thread ends
+    struct PoolRelease {
+        bool armed = false;
+
+        ~PoolRelease() {
+            if (not armed or not threadPool)
+                return;
+            auto & reg = registry();
+            std::lock_guard lock(reg.mutex);
+            reg.idle.push_back(threadPool);
+            threadPool = nullptr;
+        }
+    };
+
+    thread_local PoolRelease poolRelease;
+
+    ThreadPool & localPool() {
+        if (threadPool)
+            return *threadPool;
+
+        auto & reg = registry();
+        {
+            std::lock_guard lock(reg.mutex);
+            if (not reg.idle.empty()) {
+                threadPool = reg.idle.back();
+                reg.idle.pop_back();
+            } else {
+                threadPool = new ThreadPool;
+                reg.pools.push_back(threadPool);
+            }
+        }
+        poolRelease.armed = true;
+        return *threadPool;
+    }
+
+    std::size_t toSizeClass(std::size_t size) {
+        return (size + ALIGNMENT - 1) / ALIGNMENT - 1;
+    }
+}
+
+void * pool::allocate(std::size_t size) {
+    if (size == 0 or size > MAX_POOLED_SIZE)
+        return ::operator new(size);
+    return localPool().allocate(toSizeClass(size));
+}
+
+void pool::deallocate(void * ptr, std::size_t size) noexcept {
+    if (not ptr)
+        return;
+    if (size == 0 or size > MAX_POOLED_SIZE) {
+        ::operator delete(ptr);
+        return;
+    }
+    auto chunk = reinterpret_cast<std::uintptr_t>(ptr) & ~std::uintptr_t(CHUNK_SIZE - 1);
+    ThreadPool * owner = reinterpret_cast<ChunkHeader *>(chunk)->owner;
+    if (owner == threadPool)
+        owner->deallocate(ptr, toSizeClass(size));
+    else
+        owner->deallocateRemote(ptr, toSizeClass(size));
+}
+
+pool::Stats pool::getStats() {
+    auto & reg = registry();
+    std::lock_guard lock(reg.mutex);
+    Stats stats;
+    for (ThreadPool const * pool : reg.pools) {
+        stats.allocations += pool->allocations.load(std::memory_order_relaxed);
+        stats.reused += pool->reused.load(std::memory_order_relaxed);
+        stats.remoteFrees += pool->remoteFreeCount.load(std::memory_order_relaxed);
+        stats.chunks += pool->chunks.load(std::memory_order_relaxed);
+    }
+    stats.pools = static_cast<int>(reg.pools.size());
+    return stats;
+}
@@ -0,0 +1,95 @@
+#include<spawn_table.hpp>
+#include<utils.hpp>
+
+#include<yaml-cpp/yaml.h>
+
+#include<fmt/format.h>
+
+#include<algorithm>
+#include<iterator>
+#include<stdexcept>
+
+SpawnTable::SpawnTable(std::vector<SpawnEntry> entries, std::pair<int, int> rolls)
+    : entries(std::move(entries))
+    , rolls(rolls) {
+    buildDepthTables();
+}
+
+void SpawnTable::buildDepthTables() {
+    // the set of entries that can spawn only changes where a depth range starts or ends
+    std::vector<int> starts{ INT_MIN };
+    for (auto const & entry : entries) {
+        starts.push_back(entry.depth.first);
+        if (entry.depth.second < INT_MAX)
+            starts.push_back(entry.depth.second + 1);
+    }
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+    depthTables.clear();
+    depthTables.reserve(starts.size());
+    for (int depth : starts) {
+        DepthTable table;
+        table.firstDepth = depth;
+        std::vector<double> weights;
+        for (int i = 0; i < entries.size(); ++i) {
+            if (depth < entries[i].depth.first or depth > entries[i].depth.second)
+                continue;
+            table.entries.push_back(i);
+            weights.push_back(entries[i].weight);
+        }
+        table.weights = AliasTable(weights);
+        depthTables.push_back(std::move(table));
+    }
+}
+
+int SpawnTable::rollCount(LevelRandom & random) const {
+    return random.between(rolls.first, rolls.second);
+}
+
+SpawnEntry const * SpawnTable::pick(int depth, LevelRandom & random) const {
+    // the table after the one of `depth` is the first that starts deeper
+    auto next = std::upper_bound(depthTables.begin(), depthTables.end(), depth, [] (int depth, DepthTable const & table) {
+        return depth < table.firstDepth;
+    });
+    if (next == depthTables.begin())
+        return nullptr;
+
+    auto const & table = *std::prev(next);
+    int picked = table.weights.pick(random);
+    if (picked == -1)
+        return nullptr;
+    return &entries[table.entries[picked]];
+}
+
+namespace {
+    std::pair<int, int> readRange(YAML::Node const & node, std::string_view what) {
+        auto range = parseRange(node.as<std::string>());
+        if (not range)
+            throw std::logic_error(fmt::format("Invalid {} range '{}' in a spawn table", what, node.as<std::string>()));
+        return *range;
+    }
+}
+
+SpawnTable readSpawnTable(YAML::Node const & data, TypeIDTable const & typeIDs) {
+    std::vector<SpawnEntry> entries;
+    for (auto const & entryData : data["entries"]) {
+        auto id = entryData["id"].as<std::string>();
+
+        SpawnEntry entry;
+        entry.typeID = typeIDs.find(id);
+        if (not entry.typeID.isValid())
+            throw std::logic_error(fmt::format("Unknown type '{}' in a spawn table", id));
+        if (entryData["weight"])
+            entry.weight = entryData["weight"].as<double>();
+        if (entry.weight < 0)
+            throw std::logic_error(fmt::format("Negative spawn weight of '{}'", id));
+        if (entryData["depth"])
+            entry.depth = readRange(entryData["depth"], "depth");
+        if (entryData["count"])
+            entry.count = readRange(entryData["count"], "count");
+
+        entries.push_back(entry);
+    }
+    return SpawnTable(std::move(entries), readRange(data["rolls"], "rolls"));
+}
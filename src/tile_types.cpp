@@ -0,0 +1,22 @@
+#include<tile_types.hpp>
+
+#include<fmt/format.h>
+
+#include<stdexcept>
+#include<utility>
+
+void TileTypes::add(Tile tile, TileType type) {
+    if (isDefined(tile))
+        throw std::logic_error(fmt::format("Tile {} is defined twice", tile));
+    flags[tile] = Defined
+        | (type.walkable ? Walkable : 0)
+        | (type.opaque ? Opaque : 0)
+        | (type.diggable ? Diggable : 0);
+    types[tile] = std::move(type);
+}
+
+TileType const & TileTypes::at(Tile tile) const {
+    if (not isDefined(tile))
+        throw std::logic_error(fmt::format("Unknown tile {}", tile));
+    return types[tile];
+}
@@ -0,0 +1,32 @@
+#include<type_id.hpp>
+
+#include<stdexcept>
+
+TypeID TypeIDTable::intern(std::string_view id) {
+    auto found = find(id);
+    if (found.isValid())
+        return found;
+
+    TypeID newID{ size() };
+    names.emplace_back(id);
+    ids.emplace(names.back(), newID);
+    return newID;
+}
+
+TypeID TypeIDTable::find(std::string_view id) const {
+    auto iter = ids.find(std::string(id));
+    if (iter == ids.end())
+        return TypeID{};
+    return iter->second;
+}
+
+std::string const & TypeIDTable::getName(TypeID id) const {
+    if (not id.isValid() or id.value >= size())
+        throw std::logic_error("Trying to get a name of an unknown type");
+    return names[id.value];
+}
+
+void TypeIDTable::clear() {
+    ids.clear();
+    names.clear();
+}
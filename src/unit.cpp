@@ -6,30 +6,23 @@
 #include<items/ammo.hpp>
 #include<utils.hpp>
 #include<array2d.hpp>
-#include<game.hpp>
+#include<dungeon_level.hpp>
+#include<fov_table.hpp>
 
 #include<thread>
 #include<queue>
 #include<cassert>
 #include<iterator>
 
-static int const VISION_PRECISION = 256;
-
 Unit::Unit(Unit const & other)
     : health(other.health)
     , maxHealth(other.maxHealth)
     , pos(other.pos)
-    , id(other.id)
+    , typeID(other.typeID)
     , vision(other.vision)
     , inventory(other.inventory)
-    , weapon(), armor() {
-    if (other.weapon != nullptr) {
-        weapon = dynamic_cast<Weapon *>(&inventory[other.weapon->inventorySymbol]);
-    }
-    if (other.armor != nullptr) {
-        armor = dynamic_cast<Armor *>(&inventory[other.armor->inventorySymbol]);
-    }
-}
+    , weapon(other.weapon)
+    , armor(other.armor) {}
 
 Unit & Unit::operator =(Unit const & other) {
     if (this == &other) {
@@ -38,66 +31,46 @@ Unit & Unit::operator =(Unit const & other) {
     health = other.health;
     maxHealth = other.maxHealth;
     pos = other.pos;
-    id = other.id;
+    typeID = other.typeID;
     vision = other.vision;
+    // the inventory is shared with `other`, so its equipment pointers are valid here too
     inventory = other.inventory;
-    if (other.weapon == nullptr) {
-        weapon = nullptr;
-    } else {
-        weapon = dynamic_cast<Weapon *>(&inventory[other.weapon->inventorySymbol]);
-    }
-    if (other.armor == nullptr) {
-        armor = nullptr;
-    } else {
-        armor = dynamic_cast<Armor *>(&inventory[other.armor->inventorySymbol]);
-    }
+    weapon = other.weapon;
+    armor = other.armor;
     return *this;
 }
 
-std::string Unit::getName() {
-    return name;
+void Unit::detachInventory() {
+    if (inventory.detach())
+        rebindEquipment();
 }
 
-bool Unit::linearVisibilityCheck(Vec2d from, Vec2d to) const {
-    Vec2d d = to - from;
-    bool steep = std::abs(d.x) < std::abs(d.y);
-    if (steep) {
-        std::swap(d.x, d.y);
-        std::swap(from.x, from.y);
+void Unit::rebindEquipment() {
+    if (weapon != nullptr) {
+        weapon = dynamic_cast<Weapon *>(&inventory[weapon->inventorySymbol]);
     }
-    double k = d.y / d.x;
-    int s = sgn(d.x);
-    for (int i = 0; i * s < d.x * s; i += s) {
-        Vec2i c = from + Vec2d{ double(i), i * k };
-        if (steep)
-            std::swap(c.x, c.y);
-        if (g_game.level()[c] == 2)
-            return false;
+    if (armor != nullptr) {
+        armor = dynamic_cast<Armor *>(&inventory[armor->inventorySymbol]);
     }
-    return true;
+}
+
+std::string Unit::getName() {
+    return name;
 }
 
 void Unit::heal(int hp) {
     health = std::min(health + hp, maxHealth);
 }
 
-bool Unit::canSee(Coord2i cell) const {
-    double offset = 1.0 / VISION_PRECISION;
-    Vec2d celld{ cell };
-    return distSquared(pos, cell) < sqr(vision)
-        and (linearVisibilityCheck(Vec2d{ pos } + 0.5, celld + Vec2d{ offset, offset })
-        or linearVisibilityCheck(Vec2d{ pos } + 0.5, celld + Vec2d{ offset, 1 - offset })
-        or linearVisibilityCheck(Vec2d{ pos } + 0.5, celld + Vec2d{ 1 - offset, offset })
-        or linearVisibilityCheck(Vec2d{ pos } + 0.5, celld + Vec2d{ 1 - offset, 1 - offset }));
+bool Unit::canSee(DungeonLevel const & level, Coord2i cell) const {
+    return distSquared(pos, cell) < sqr(vision) and fov::isVisible(level.tiles, level.tileTypes, pos, cell);
 }
 
-void Unit::setTo(Coord2i cell) {
-    auto & unitsMap = g_game.getUnitsMap();
-    if (g_game.level()[cell] == 2 or unitsMap[cell] or pos == cell)
+void Unit::setTo(DungeonLevel & level, Coord2i cell) {
+    if (not level.freeCells.contains(cell))
         return;
 
-    unitsMap[cell] = std::move(unitsMap[pos]);
-    pos = cell;
+    level.moveUnit(pos, cell);
 }
 
 void Unit::dealDamage(int damage) {
@@ -107,12 +80,13 @@ void Unit::dealDamage(int damage) {
     health -= damage * (100 - defence) / 100.f;
 }
 
-void Unit::dropInventory() {
+void Unit::dropInventory(DungeonLevel & level) {
+    detachInventory();
     weapon = nullptr;
     takeArmorOff();
     while (not inventory.isEmpty()) {
         auto id = inventory.begin()->second->inventorySymbol;
-        g_game.drop(inventory.remove(id), pos);
+        level.drop(inventory.remove(id), pos);
     }
     assert(inventory.isEmpty());
 }
@@ -5,3 +5,21 @@ void sleep(double sec) {
     std::this_thread::sleep_for(std::chrono::duration<double>(sec));
 }
 
+tl::optional<std::pair<int, int>> parseRange(std::string const & toParse) {
+    auto delimIndex = toParse.find("..");
+    if (delimIndex == std::string::npos) {
+        try {
+            int asInt = std::stoi(toParse);
+            return std::make_pair(asInt, asInt);
+        } catch (...) {
+            return tl::nullopt;
+        }
+    }
+    try {
+        return std::make_pair(
+                std::stoi(toParse.substr(0, delimIndex)),
+                std::stoi(toParse.substr(delimIndex + 2)));
+    } catch (...) {
+        return tl::nullopt;
+    }
+}
@@ -3,68 +3,69 @@
 #include<items/ammo.hpp>
 
 #include<cassert>
+#include<algorithm>
 #include<memory>
 
 Weapon::Cartridge::Cartridge(int capacity): capacity(capacity) {
     assert(capacity >= 0);
 }
 
-Weapon::Cartridge::Cartridge(Cartridge const & other): capacity(other.capacity) {
-    for (auto const & bullet : other) {
-        loaded.push_back(std::make_unique<Ammo>(*bullet));
+int Weapon::Cartridge::load(Ammo const & prototype, int count) {
+    count = std::min(count, capacity - size);
+    if (count <= 0) {
+        return 0;
     }
-}
-
-Weapon::Cartridge & Weapon::Cartridge::operator =(Cartridge const & other) {
-    capacity = other.capacity;
-    loaded.clear();
-    for (auto const & bullet : other) {
-        loaded.push_back(std::make_unique<Ammo>(*bullet));
-    }
-    return *this;
-}
-
-Ptr<Ammo> Weapon::Cartridge::load(Ptr<Ammo> bullet) {
-    if (loaded.size() == capacity) {
-        return bullet;
+    if (not runs.empty() and runs.back().ammo->getTypeID() == prototype.getTypeID()) {
+        runs.back().count += count;
+    } else {
+        runs.push_back(Run{ &prototype, count });
     }
-    loaded.push_back(std::move(bullet));
-    return nullptr;
+    size += count;
+    return count;
 }
 
 Ptr<Ammo> Weapon::Cartridge::unloadOne() {
-    if (loaded.empty()) {
+    if (isEmpty()) {
         return nullptr;
     }
-    auto bullet = std::move(loaded.back());
-    loaded.pop_back();
+    auto bullet = runs.back().ammo->clone();
+    bullet->count = 1;
+    fireOne();
     return bullet;
 }
 
-Ammo & Weapon::Cartridge::next() {
-    assert(not isEmpty());
-    return *loaded.back();
+void Weapon::Cartridge::fireOne() {
+    if (isEmpty()) {
+        return;
+    }
+    if (--runs.back().count == 0) {
+        runs.pop_back();
+    }
+    --size;
 }
 
 Ammo const & Weapon::Cartridge::next() const {
     assert(not isEmpty());
-    return *loaded.back();
+    return *runs.back().ammo;
 }
 
 Ammo const * Weapon::Cartridge::operator [](int ind) const {
     assert(ind >= 0 and ind < capacity);
-    if (ind < loaded.size()) {
-        return loaded[ind].get();
+    for (auto const & run : runs) {
+        if (ind < run.count) {
+            return run.ammo;
+        }
+        ind -= run.count;
     }
     return nullptr;
 }
 
-auto Weapon::Cartridge::begin() const -> decltype(loaded.begin()) {
-    return loaded.begin();
+auto Weapon::Cartridge::begin() const -> decltype(runs.begin()) {
+    return runs.begin();
 }
 
-auto Weapon::Cartridge::end() const -> decltype(loaded.end()) {
-    return loaded.end();
+auto Weapon::Cartridge::end() const -> decltype(runs.end()) {
+    return runs.end();
 }
 
 int Weapon::Cartridge::getCapacity() const {
@@ -72,14 +73,13 @@ int Weapon::Cartridge::getCapacity() const {
 }
 
 int Weapon::Cartridge::getCurrSize() const {
-    return (int) loaded.size();
+    return size;
 }
 
 bool Weapon::Cartridge::isEmpty() const {
-    return loaded.empty();
+    return size == 0;
 }
 
 bool Weapon::Cartridge::isFull() const {
-    return loaded.size() == capacity;
+    return size == capacity;
 }
-
@@ -11,7 +11,7 @@
 #include<items/scroll.hpp>
 #include<items/potion.hpp>
 #include<yaml_file_cache.hpp>
-#include<game.hpp>
+#include<game_data.hpp>
 
 #include<yaml-cpp/yaml.h>
 
@@ -22,49 +22,51 @@
 void YAMLItemLoader::load() {
     YAML::Node registry = yamlFileCache["data/items.yaml"];
 
-    g_game.getFoodTypes().clear();
-    g_game.getArmorTypes().clear();
-    g_game.getWeaponTypes().clear();
-    g_game.getAmmoTypes().clear();
-    g_game.getScrollTypes().clear();
-    g_game.getPotionTypes().clear();
+    data.getFoodTypes().clear();
+    data.getArmorTypes().clear();
+    data.getWeaponTypes().clear();
+    data.getAmmoTypes().clear();
+    data.getScrollTypes().clear();
+    data.getPotionTypes().clear();
+    data.clearItemTypes();
 
     for (auto const & id : registry["food"]) {
         auto idstr = id.as<std::string>();
-        g_game.getFoodTypes()[idstr] = loadFood(idstr);
+        data.getFoodTypes()[data.getItemTypeIDs().intern(idstr)] = loadFood(idstr);
     }
 
     for (auto const & id : registry["armor"]) {
         auto idstr = id.as<std::string>();
-        g_game.getArmorTypes()[idstr] = loadArmor(idstr);
+        data.getArmorTypes()[data.getItemTypeIDs().intern(idstr)] = loadArmor(idstr);
     }
 
     for (auto const & id : registry["weapon"]) {
         auto idstr = id.as<std::string>();
-        g_game.getWeaponTypes()[idstr] = loadWeapon(idstr);
+        data.getWeaponTypes()[data.getItemTypeIDs().intern(idstr)] = loadWeapon(idstr);
     }
 
     for (auto const & id : registry["ammo"]) {
         auto idstr = id.as<std::string>();
-        g_game.getAmmoTypes()[idstr] = loadAmmo(idstr);
+        data.getAmmoTypes()[data.getItemTypeIDs().intern(idstr)] = loadAmmo(idstr);
     }
 
     for (auto const & id : registry["scroll"]) {
         auto idstr = id.as<std::string>();
-        g_game.getScrollTypes()[idstr] = loadScroll(idstr);
+        data.getScrollTypes()[data.getItemTypeIDs().intern(idstr)] = loadScroll(idstr);
     }
 
     for (auto const & id : registry["potion"]) {
         auto idstr = id.as<std::string>();
-        g_game.getPotionTypes()[idstr] = loadPotion(idstr);
+        data.getPotionTypes()[data.getItemTypeIDs().intern(idstr)] = loadPotion(idstr);
     }
 }
 
-void initItemBase(Item & item, YAML::Node const & data) {
-    item.weight = data["weight"].as<int>();
-    item.id = data["id"].as<std::string>();
-    item.isStackable = data["isStackable"].as<bool>();
-    item.name = data["name"].as<std::string>();
+void initItemBase(Item & item, YAML::Node const & itemData, GameData & data) {
+    auto & typeInfo = data.addItemType(itemData["id"].as<std::string>());
+    typeInfo.weight = itemData["weight"].as<int>();
+    typeInfo.isStackable = itemData["isStackable"].as<bool>();
+    typeInfo.name = itemData["name"].as<std::string>();
+    item.typeInfo = &typeInfo;
 }
 
 YAML::Node loadItemData(std::string_view id, YAMLFileCache & yamlFileCache) {
@@ -75,7 +77,7 @@ YAML::Node loadItemData(std::string_view id, YAMLFileCache & yamlFileCache) {
 Ptr<Food> YAMLItemLoader::loadFood(std::string_view id) {
     YAML::Node item = loadItemData(id, yamlFileCache);
     auto loaded = std::make_unique<Food>();
-    initItemBase(*loaded, item);
+    initItemBase(*loaded, item, data);
     loaded->nutritionalValue = item["food"]["nutritionalValue"].as<int>();
     return loaded;
 }
@@ -83,7 +85,7 @@ Ptr<Food> YAMLItemLoader::loadFood(std::string_view id) {
 Ptr<Armor> YAMLItemLoader::loadArmor(std::string_view id) {
     YAML::Node item = loadItemData(id, yamlFileCache);
     auto loaded = std::make_unique<Armor>();
-    initItemBase(*loaded, item);
+    initItemBase(*loaded, item, data);
     loaded->durability = item["armor"]["durability"].as<int>();
     loaded->defence = item["armor"]["defence"].as<int>();
     return loaded;
@@ -92,7 +94,7 @@ Ptr<Armor> YAMLItemLoader::loadArmor(std::string_view id) {
 Ptr<Ammo> YAMLItemLoader::loadAmmo(std::string_view id) {
     YAML::Node item = loadItemData(id, yamlFileCache);
     auto loaded = std::make_unique<Ammo>();
-    initItemBase(*loaded, item);
+    initItemBase(*loaded, item, data);
     loaded->damage = item["ammo"]["damage"].as<int>();
     loaded->range = item["ammo"]["range"].as<int>();
     return loaded;
@@ -101,7 +103,7 @@ Ptr<Ammo> YAMLItemLoader::loadAmmo(std::string_view id) {
 Ptr<Weapon> YAMLItemLoader::loadWeapon(std::string_view id) {
     YAML::Node item = loadItemData(id, yamlFileCache);
     auto loaded = std::make_unique<Weapon>();
-    initItemBase(*loaded, item);
+    initItemBase(*loaded, item, data);
     loaded->damage = item["weapon"]["damage"].as<int>();
     if (item["weapon"]["ranged"]) {
         loaded->isRanged = true;
@@ -129,7 +131,7 @@ tl::optional<Scroll::Effect> toScrollEffect(std::string_view effectString) {
 Ptr<Scroll> YAMLItemLoader::loadScroll(std::string_view id) {
     YAML::Node item = loadItemData(id, yamlFileCache);
     auto loaded = std::make_unique<Scroll>();
-    initItemBase(*loaded, item);
+    initItemBase(*loaded, item, data);
     auto optEffect = toScrollEffect(item["scroll"]["effect"].as<std::string>());
     if (not optEffect)
         throw std::logic_error(fmt::format("Failed to parse a scroll effect of '{}'", id));
@@ -140,7 +142,7 @@ Ptr<Scroll> YAMLItemLoader::loadScroll(std::string_view id) {
 Ptr<Potion> YAMLItemLoader::loadPotion(std::string_view id) {
     YAML::Node item = loadItemData(id, yamlFileCache);
     auto loaded = std::make_unique<Potion>();
-    initItemBase(*loaded, item);
+    initItemBase(*loaded, item, data);
     return loaded;
 }
 
@@ -11,48 +11,30 @@
 #include<items/ammo.hpp>
 #include<units/hero.hpp>
 #include<units/enemy.hpp>
-#include<game.hpp>
+#include<game_data.hpp>
+#include<utils.hpp>
 
 #include<fmt/format.h>
 #include<tl/optional.hpp>
 
 void YAMLUnitLoader::load() {
-    g_game.setHeroTemplate(loadHero());
+    data.setHeroTemplate(loadHero());
 
     auto const & enemyRegistry = yamlFileCache["data/units/enemies.yaml"];
     for (auto const & id : enemyRegistry) {
         auto idString = id.as<std::string>();
-        g_game.getEnemyTypes()[idString] = loadEnemy(idString);
+        data.getEnemyTypes()[data.getUnitTypeIDs().intern(idString)] = loadEnemy(idString);
     }
 }
 
-tl::optional<std::pair<int, int>> parseRange(std::string const & toParse) {
-    auto delimIndex = toParse.find("..");
-    if (delimIndex == std::string::npos) {
-        try {
-            int asInt = std::stoi(toParse);
-            return std::make_pair(asInt, asInt);
-        } catch (...) {
-            return tl::nullopt;
-        }
-    }
-    try {
-        return std::make_pair(
-                std::stoi(toParse.substr(0, delimIndex)),
-                std::stoi(toParse.substr(delimIndex + 2)));
-    } catch (...) {
-        return tl::nullopt;
-    }
-}
-
-Ptr<Item> createItem(YAML::Node const & itemData){
-    auto item = g_game.createItem(itemData["id"].as<std::string>());
+Ptr<Item> createItem(YAML::Node const & itemData, GameData const & data) {
+    auto item = data.createItem(itemData["id"].as<std::string>());
     if (not item)
         return nullptr;
 
     if (itemData["count"]) {
         auto optRange = parseRange(itemData["count"].as<std::string>());
-        if (not item->isStackable or not optRange)
+        if (not item->isStackable() or not optRange)
             return nullptr;
 
         item->count = Random::get(optRange->first, optRange->second);
@@ -61,28 +43,28 @@ Ptr<Item> createItem(YAML::Node const & itemData){
     return item;
 }
 
-void loadUnitInventory(Unit & unit, YAML::Node const & invData) {
+void loadUnitInventory(Unit & unit, YAML::Node const & invData, GameData const & data) {
     for (auto const & entry : invData) {
         char at = entry.first.as<char>();
-        auto item = createItem(entry.second);
+        auto item = createItem(entry.second, data);
         unit.inventory.add(std::move(item), at);
     }
 }
 
-void initUnitBase(Unit & unit, YAML::Node const & data) {
-    unit.id = data["id"].as<std::string>();
-    unit.name = data["name"].as<std::string>();
-    unit.health = data["health"].as<int>();
-    unit.maxHealth = data["maxHealth"].as<int>();
-    unit.vision = data["visionDistance"].as<int>();
-    if (data["inventory"])
-        loadUnitInventory(unit, data["inventory"]);
-    if (data["armor"]) {
-        char at = data["armor"].as<char>();
+void initUnitBase(Unit & unit, YAML::Node const & unitData, GameData & data) {
+    unit.typeID = data.getUnitTypeIDs().intern(unitData["id"].as<std::string>());
+    unit.name = unitData["name"].as<std::string>();
+    unit.health = unitData["health"].as<int>();
+    unit.maxHealth = unitData["maxHealth"].as<int>();
+    unit.vision = unitData["visionDistance"].as<int>();
+    if (unitData["inventory"])
+        loadUnitInventory(unit, unitData["inventory"], data);
+    if (unitData["armor"]) {
+        char at = unitData["armor"].as<char>();
         unit.armor = dynamic_cast<Armor *>(&unit.inventory[at]);
     }
-    if (data["weapon"]) {
-        char at = data["weapon"].as<char>();
+    if (unitData["weapon"]) {
+        char at = unitData["weapon"].as<char>();
         unit.weapon = dynamic_cast<Weapon *>(&unit.inventory[at]);
     }
 }
@@ -90,7 +72,7 @@ void initUnitBase(Unit & unit, YAML::Node const & data) {
 Ptr<Hero> YAMLUnitLoader::loadHero() {
     auto heroData = yamlFileCache["data/units/hero.yaml"];
     auto hero = std::make_unique<Hero>();
-    initUnitBase(*hero, heroData);
+    initUnitBase(*hero, heroData, data);
     hero->maxBurden = heroData["hero"]["maxBurden"].as<int>();
     hero->hunger = heroData["hero"]["hunger"].as<int>();
     return hero;
@@ -100,7 +82,7 @@ Ptr<Enemy> YAMLUnitLoader::loadEnemy(std::string const & id) {
     auto filename = fmt::format("data/units/enemies/{}.yaml", id);
     auto enemyData = yamlFileCache[filename];
     auto enemy = std::make_unique<Enemy>();
-    initUnitBase(*enemy, enemyData);
+    initUnitBase(*enemy, enemyData, data);
     enemy->xpCost = enemyData["enemy"]["xpCost"].as<int>();
     if (enemyData["enemy"]["ammo"]) {
         char at = enemyData["enemy"]["ammo"].as<char>();
@@ -0,0 +1,50 @@
+// Measures steps of the cave automaton per second on a large grid:
+//
+//     cave_bench [cols rows [steps]]
+//
+// 1024x1024 cells and 1000 steps by default.
+
+#include<gen_caves.hpp>
+
+#include<bitset>
+#include<chrono>
+#include<iostream>
+#include<string>
+#include<utility>
+
+int main(int argc, char ** argv) {
+    if (argc != 1 and argc != 3 and argc != 4) {
+        std::cerr << "usage: cave_bench [cols rows [steps]]\n";
+        return 2;
+    }
+    int cols = argc >= 3 ? std::stoi(argv[1]) : 1024;
+    int rows = argc >= 3 ? std::stoi(argv[2]) : 1024;
+    int steps = argc == 4 ? std::stoi(argv[3]) : 1000;
+    if (cols <= 0 or rows <= 0 or steps <= 0) {
+        std::cerr << "cave_bench: sizes and steps must be positive\n";
+        return 2;
+    }
+
+    gen::BitGrid grid(rows, cols);
+    gen::BitGrid next(rows, cols);
+    LevelRandom random(1);
+    gen::fillCaveNoise(grid, random);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step) {
+        gen::stepCaves(grid, next, gen::CAVE_RULE);
+        std::swap(grid, next);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // the result is used, so the steps can't be optimized away
+    long long walls = 0;
+    for (int r = 0; r < rows; ++r)
+        for (int k = 0; k < grid.getWordsPerRow(); ++k)
+            walls += std::bitset<64>(grid.row(r)[k]).count();
+
+    std::cout << cols << "x" << rows << ", " << steps << " steps in " << elapsed.count() << " s: "
+        << steps / elapsed.count() << " steps/s, "
+        << double(rows) * cols * steps / elapsed.count() / 1e9 << " Gcells/s, "
+        << walls << " wall bits at the end\n";
+}
@@ -0,0 +1,487 @@
+// Hosts many games in one process. Every session is a Game with a screen and a key queue of
+// its own; a pool of worker threads steps the sessions that have keys waiting. The data from
+// data/ is loaded once and shared by all of them.
+//
+// There is no network yet, the clients are simulated: each sends a command at a fixed rate,
+// a session whose hero dies or quits starts a new game. Commands that prompt, like wearing or
+// throwing, are sent a key at a time, so the prompt waits for the rest as it would for a player.
+// The report tells how much CPU time the workers took, so how many sessions a core keeps up
+// with at that rate, how long keys waited and how long the prompts waited for keys. It also
+// tells how many chunks the object pools took by half of the run and by its end, they should
+// stop growing once the sessions have played for a while.
+//
+//     game_server [options]
+//
+//     --sessions N  100 by default
+//     --threads N   workers, all cores by default
+//     --rate R      commands a second per client, 2 by default
+//     --seconds S   how long to run, 10 by default
+//     --caves       cave levels instead of mazes
+//
+// Run it from the game directory, the game data is read from data/.
+
+#include<game.hpp>
+#include<game_data.hpp>
+#include<object_pool.hpp>
+#include<termlib/abstract_terminal_window.hpp>
+
+#include<effolkronium/random.hpp>
+
+#include<algorithm>
+#include<chrono>
+#include<condition_variable>
+#include<cstdio>
+#include<ctime>
+#include<deque>
+#include<functional>
+#include<iostream>
+#include<memory>
+#include<mutex>
+#include<stdexcept>
+#include<string>
+#include<thread>
+#include<utility>
+#include<vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        int sessions = 100;
+        int threads = 0;
+        double rate = 2;
+        double seconds = 10;
+        bool caves = false;
+    };
+
+    //////////////////////////////////////////////////
+    // The terminal of a session: draws into a screen buffer, which a network server would
+    // send to the client after every turn, and reads the keys the client has sent. A prompt
+    // that wants more keys than have arrived waits for them on its worker; the wait is
+    // announced to `onWait` and `onWake`, so the server can step other sessions meanwhile.
+    class SessionWindow : public AbstractTerminalWindow {
+    public:
+        static int const WIDTH = 200;
+        static int const HEIGHT = 100;
+
+        struct Key {
+            char ch;
+            Clock::time_point sent;
+        };
+
+        std::function<void()> onWait;
+        std::function<void()> onWake;
+
+        // the waits of the prompts until step() collects them, only the stepping worker uses them
+        int waits = 0;
+        std::chrono::duration<double> waited{};
+
+        SessionWindow(): screen(WIDTH * HEIGHT, ' ') {}
+
+        void send(std::string_view keys, Clock::time_point sent) {
+            {
+                std::lock_guard lock(keysMutex);
+                for (char ch : keys)
+                    this->keys.push_back(Key{ ch, sent });
+            }
+            keysChanged.notify_one();
+        }
+
+        bool hasKeys() const {
+            std::lock_guard lock(keysMutex);
+            return not keys.empty();
+        }
+
+        // when the last key taken was sent
+        Clock::time_point lastSent() const {
+            return lastKeySent;
+        }
+
+        // the next key and when it was sent, waits for one if there is none
+        Key takeKey() {
+            std::unique_lock lock(keysMutex);
+            if (not closed and keys.empty()) {
+                lock.unlock();
+                onWait();
+                auto waitBegin = Clock::now();
+                lock.lock();
+                keysChanged.wait(lock, [this] { return closed or not keys.empty(); });
+                lock.unlock();
+                ++waits;
+                waited += Clock::now() - waitBegin;
+                onWake();
+                lock.lock();
+            }
+            Key key{ '\033', Clock::now() };
+            if (not keys.empty()) {
+                key = keys.front();
+                keys.pop_front();
+            }
+            lastKeySent = key.sent;
+            return key;
+        }
+
+        // from now on a prompt that waits for keys gets escape, so it is cancelled
+        void close() {
+            {
+                std::lock_guard lock(keysMutex);
+                closed = true;
+            }
+            keysChanged.notify_all();
+        }
+
+        void setCursorPosition(Coord2i position) override {
+            cursor = position;
+        }
+
+        Coord2i getCursorPosition() const override {
+            return cursor;
+        }
+
+        void put(char ch) override {
+            if (cursor.x >= 0 and cursor.x < WIDTH and cursor.y >= 0 and cursor.y < HEIGHT)
+                screen[cursor.y * WIDTH + cursor.x] = ch;
+            ++cursor.x;
+        }
+
+        void display() override {}
+
+        tl::optional<char> getChar(int = -1) override {
+            return takeKey().ch;
+        }
+
+        void setTextStyle(TextStyle) override {}
+
+        void setEchoing(bool echo) override {
+            echoing = echo;
+        }
+
+        Size2i getSize() const override {
+            return Size2i{ WIDTH, HEIGHT };
+        }
+
+        void clear(Color = Color::Black) override {
+            std::fill(screen.begin(), screen.end(), ' ');
+            cursor = Coord2i{};
+        }
+
+    private:
+        std::vector<char> screen;
+        Coord2i cursor;
+
+        mutable std::mutex keysMutex;
+        std::condition_variable keysChanged;
+        std::deque<Key> keys;
+        bool closed = false;
+        Clock::time_point lastKeySent;
+    };
+
+    struct Session {
+        SessionWindow window;
+        Ptr<Game> game;
+        bool scheduled = false; // waiting in the ready queue or being stepped
+    };
+
+    struct WorkerStats {
+        std::chrono::duration<double> cpu{}; // not counting the waits for work
+        long turns = 0;
+        long games = 0;
+        long promptWaits = 0;
+        std::chrono::duration<double> promptWaited{};
+        std::vector<double> latencies; // milliseconds from the last key of a turn to its end
+    };
+
+    //////////////////////////////////////////////////
+    // Steps the sessions with keys on a pool of threads. A session is stepped by one worker
+    // at a time, until its keys run out, then it waits for the next send() to be scheduled again.
+    // At most `threads` workers step at once. A worker whose prompt waits for keys doesn't
+    // count, an idle worker steps the next session in its place, or a new one if there is none,
+    // so the waits of the prompts don't take the workers away from the other sessions.
+    class Server {
+    public:
+        Server(GameData const & data, Options const & options)
+            : data(data)
+            , options(options)
+            , sessions(options.sessions) {
+            for (auto & session : sessions) {
+                session.window.onWait = [this] { promptWaiting(); };
+                session.window.onWake = [this] { promptWoken(); };
+                startGame(session);
+            }
+        }
+
+        Server(Server const &) = delete;
+        Server & operator=(Server const &) = delete;
+
+        void start() {
+            std::lock_guard lock(readyMutex);
+            for (int i = 0; i < options.threads; ++i)
+                workers.emplace_back(&Server::work, this);
+        }
+
+        // what the client of session `index` typed
+        void send(int index, std::string_view keys) {
+            auto & session = sessions[index];
+            session.window.send(keys, Clock::now());
+
+            // the worker decides under the same lock whether the session is done, so keys
+            // sent while it is being stepped are either seen by it or schedule it again
+            {
+                std::lock_guard lock(readyMutex);
+                if (session.scheduled)
+                    return;
+                session.scheduled = true;
+                ready.push_back(&session);
+            }
+            readyChanged.notify_one();
+        }
+
+        std::vector<WorkerStats> stop() {
+            {
+                std::lock_guard lock(readyMutex);
+                stopping = true;
+            }
+            readyChanged.notify_all();
+            for (auto & session : sessions)
+                session.window.close();
+            // no workers are added once stopping is set
+            for (auto & worker : workers)
+                worker.join();
+            return std::move(stats);
+        }
+
+        // every worker started, the ones that stood in for waiting prompts too
+        int workerCount() const {
+            return static_cast<int>(workers.size());
+        }
+
+    private:
+        void startGame(Session & session) {
+            session.game = std::make_unique<Game>(data, session.window);
+            session.game->setLevelGenerator(options.caves ? LevelGenerator::Caves : LevelGenerator::Maze);
+            session.game->setAnimated(false);
+            session.game->setBuildLevelsInBackground(false);
+            session.game->start();
+        }
+
+        void step(Session & session, WorkerStats & stats) {
+            while (session.window.hasKeys()) {
+                bool playing = session.game->handleKey(session.window.takeKey().ch);
+                // a turn that prompted ends when its last key is there, that's what the client waits for
+                std::chrono::duration<double, std::milli> latency = Clock::now() - session.window.lastSent();
+                stats.latencies.push_back(latency.count());
+                ++stats.turns;
+                if (not playing) {
+                    ++stats.games;
+                    startGame(session);
+                }
+            }
+            stats.promptWaits += std::exchange(session.window.waits, 0);
+            stats.promptWaited += std::exchange(session.window.waited, {});
+        }
+
+        // the worker stepping the session leaves its place to another one until the keys come
+        void promptWaiting() {
+            {
+                std::lock_guard lock(readyMutex);
+                --stepping;
+                if (not stopping and idle == 0)
+                    workers.emplace_back(&Server::work, this);
+            }
+            readyChanged.notify_one();
+        }
+
+        // back from a prompt, the worker may step over the limit until it is done with the session
+        void promptWoken() {
+            std::lock_guard lock(readyMutex);
+            ++stepping;
+        }
+
+        void work() {
+            WorkerStats local;
+            std::unique_lock lock(readyMutex);
+            while (true) {
+                ++idle;
+                readyChanged.wait(lock, [this] {
+                    return stopping or (not ready.empty() and stepping < options.threads);
+                });
+                --idle;
+                if (stopping)
+                    break;
+
+                Session & session = *ready.front();
+                ready.pop_front();
+                ++stepping;
+                lock.unlock();
+
+                step(session, local);
+
+                lock.lock();
+                --stepping;
+                if (session.window.hasKeys())
+                    ready.push_back(&session);
+                else
+                    session.scheduled = false;
+            }
+            timespec cpu;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+            local.cpu = std::chrono::seconds(cpu.tv_sec) + std::chrono::nanoseconds(cpu.tv_nsec);
+            stats.push_back(std::move(local));
+        }
+
+        GameData const & data;
+        Options const & options;
+        std::vector<Session> sessions;
+
+        std::vector<std::thread> workers;
+        std::vector<WorkerStats> stats; // by worker, added when they stop
+
+        std::mutex readyMutex;
+        std::condition_variable readyChanged;
+        std::deque<Session *> ready;
+        int stepping = 0; // workers stepping a session, not counting the ones waiting in a prompt
+        int idle = 0; // workers waiting for a session to step
+        bool stopping = false;
+    };
+
+    using Command = std::vector<std::string_view>;
+
+    // Mostly walking, now and then picking up, looking at the inventory or taking the stairs.
+    // The rest are sent a part at a time, each part on the next turn of the client: wearing and
+    // dropping wait for the letter of the item, throwing for the item and then the direction,
+    // escape asks whether to quit. The hero starts with armor under 'a'.
+    Command const & randomCommand() {
+        static Command const commands[] = {
+            { "h" }, { "j" }, { "k" }, { "l" }, { "y" }, { "u" }, { "b" }, { "n" },
+            { "h" }, { "j" }, { "k" }, { "l" }, { "y" }, { "u" }, { "b" }, { "n" },
+            { ",\n" }, { "i\n" }, { ">" }, { "<" },
+            { "W", "a" }, { "d", "a" }, { "t", "a", "h" }, { "\033", "n" }
+        };
+        return *effolkronium::random_thread_local::get(std::begin(commands), std::end(commands));
+    }
+
+    void printUsage() {
+        std::cerr << "usage: game_server [--sessions N] [--threads N] [--rate R] [--seconds S] [--caves]\n";
+    }
+
+    Options parseOptions(int argc, char ** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&] {
+                if (i + 1 == argc)
+                    throw std::logic_error("'" + arg + "' needs a value");
+                return std::string(argv[++i]);
+            };
+
+            if (arg == "--sessions") {
+                options.sessions = std::stoi(value());
+            } else if (arg == "--threads") {
+                options.threads = std::stoi(value());
+            } else if (arg == "--rate") {
+                options.rate = std::stod(value());
+            } else if (arg == "--seconds") {
+                options.seconds = std::stod(value());
+            } else if (arg == "--caves") {
+                options.caves = true;
+            } else {
+                throw std::logic_error("Unknown option '" + arg + "'");
+            }
+        }
+        if (options.threads <= 0)
+            options.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (options.sessions < 1)
+            throw std::logic_error("There has to be a session");
+        if (options.rate <= 0 or options.seconds <= 0)
+            throw std::logic_error("The rate and the time have to be positive");
+        return options;
+    }
+
+    double percentile(std::vector<double> & values, double share) {
+        if (values.empty())
+            return 0;
+        auto nth = values.begin() + static_cast<std::ptrdiff_t>(share * (values.size() - 1));
+        std::nth_element(values.begin(), nth, values.end());
+        return *nth;
+    }
+}
+
+int main(int argc, char ** argv) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (std::exception const & e) {
+        std::cerr << "game_server: " << e.what() << '\n';
+        printUsage();
+        return 2;
+    }
+
+    GameData data;
+    try {
+        data.load();
+    } catch (std::exception const & e) {
+        std::cerr << "game_server: can't load the game data: " << e.what() << '\n';
+        return 1;
+    }
+
+    auto setupBegin = Clock::now();
+    Server server(data, options);
+    std::chrono::duration<double> setup = Clock::now() - setupBegin;
+    server.start();
+
+    // the clients take turns, so the commands are spread evenly over time
+    std::chrono::duration<double> const interval{ 1 / (options.rate * options.sessions) };
+    auto const begin = Clock::now();
+    auto const end = begin + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    std::vector<std::deque<std::string_view>> unsent(options.sessions); // the parts of the commands to come
+    auto const half = begin + (end - begin) / 2;
+    long long halfChunks = -1;
+    long sent = 0;
+    for (auto next = begin; next < end; next += std::chrono::duration_cast<Clock::duration>(interval)) {
+        std::this_thread::sleep_until(next);
+        if (halfChunks < 0 and next >= half)
+            halfChunks = pool::getStats().chunks;
+        auto & parts = unsent[sent % options.sessions];
+        if (parts.empty()) {
+            auto const & command = randomCommand();
+            parts.assign(command.begin(), command.end());
+        }
+        server.send(static_cast<int>(sent % options.sessions), parts.front());
+        parts.pop_front();
+        ++sent;
+    }
+
+    auto stats = server.stop();
+    std::chrono::duration<double> elapsed = Clock::now() - begin;
+
+    std::chrono::duration<double> cpu{};
+    long turns = 0;
+    long games = 0;
+    long promptWaits = 0;
+    std::chrono::duration<double> promptWaited{};
+    std::vector<double> latencies;
+    for (auto & worker : stats) {
+        cpu += worker.cpu;
+        turns += worker.turns;
+        games += worker.games;
+        promptWaits += worker.promptWaits;
+        promptWaited += worker.promptWaited;
+        latencies.insert(latencies.end(), worker.latencies.begin(), worker.latencies.end());
+    }
+
+    double cores = cpu.count() / elapsed.count();
+    std::fprintf(stderr, "%d sessions on %d threads, %.1f commands/s each for %.1f s (%.2f s to start them)\n",
+            options.sessions, options.threads, options.rate, elapsed.count(), setup.count());
+    std::fprintf(stderr, "%ld sends, %ld turns played, %ld games over\n", sent, turns, games);
+    std::fprintf(stderr, "prompts waited for keys %ld times, %.1f s in all; %d workers started, the ones standing in for them too\n",
+            promptWaits, promptWaited.count(), server.workerCount());
+    std::fprintf(stderr, "%.1f us a turn, the workers used %.2f cores: %.0f sessions per core\n",
+            turns ? cpu.count() * 1e6 / turns : 0.0,
+            cores, cores > 0 ? options.sessions / cores : 0.0);
+    auto poolStats = pool::getStats();
+    std::fprintf(stderr, "object pools: %d, %lld chunks by half of the run, %lld at the end, %.0f%% of the blocks freed on another thread\n",
+            poolStats.pools, halfChunks, poolStats.chunks,
+            poolStats.allocations ? 100.0 * poolStats.remoteFrees / poolStats.allocations : 0.0);
+    std::fprintf(stderr, "key to end of turn: p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+            percentile(latencies, 0.5), percentile(latencies, 0.99), percentile(latencies, 1));
+}
@@ -0,0 +1,163 @@
+// Checks the fixed point line of sight against the floating point one it replaced, on random
+// maps with 5% to 50% walls, and times both:
+//
+//     los_check [maps [radius]]
+//
+// 30 maps and every pair of cells closer than 24 by default, so the pairs past the ray table
+// radius go through los::isVisible. Exits with 1 if some pair is seen differently.
+
+#include<line_of_sight.hpp>
+#include<fov_table.hpp>
+#include<level_random.hpp>
+#include<utils.hpp>
+
+#include<chrono>
+#include<cmath>
+#include<iostream>
+#include<memory>
+#include<string>
+#include<utility>
+#include<vector>
+
+namespace {
+    // The double precision check of Unit::canSee before the fixed point rewrite, as it was
+    namespace reference {
+        int const VISION_PRECISION = 256;
+
+        bool linearVisibilityCheck(LevelData const & level, TileTypes const & tileTypes, Vec2d from, Vec2d to) {
+            Vec2d d = to - from;
+            bool steep = std::abs(d.x) < std::abs(d.y);
+            if (steep) {
+                std::swap(d.x, d.y);
+                std::swap(from.x, from.y);
+            }
+            double k = d.y / d.x;
+            int s = sgn(d.x);
+            for (int i = 0; i * s < d.x * s; i += s) {
+                Vec2i c = from + Vec2d{ double(i), i * k };
+                if (steep)
+                    std::swap(c.x, c.y);
+                if (tileTypes.isOpaque(level[c]))
+                    return false;
+            }
+            return true;
+        }
+
+        bool isVisible(LevelData const & level, TileTypes const & tileTypes, Coord2i pos, Coord2i cell) {
+            double offset = 1.0 / VISION_PRECISION;
+            Vec2d celld{ cell };
+            return linearVisibilityCheck(level, tileTypes, Vec2d{ pos } + 0.5, celld + Vec2d{ offset, offset })
+                or linearVisibilityCheck(level, tileTypes, Vec2d{ pos } + 0.5, celld + Vec2d{ offset, 1 - offset })
+                or linearVisibilityCheck(level, tileTypes, Vec2d{ pos } + 0.5, celld + Vec2d{ 1 - offset, offset })
+                or linearVisibilityCheck(level, tileTypes, Vec2d{ pos } + 0.5, celld + Vec2d{ 1 - offset, 1 - offset });
+        }
+    }
+
+    struct Pair {
+        Coord2i from;
+        Coord2i to;
+    };
+
+    // the two tiles the level generators use, the rest of data/tiles.yaml doesn't matter here
+    TileTypes makeTileTypes() {
+        TileTypes tileTypes;
+        TileType floor;
+        floor.name = "floor";
+        floor.walkable = true;
+        tileTypes.add(tile::FLOOR, floor);
+        TileType wall;
+        wall.name = "wall";
+        wall.opaque = true;
+        tileTypes.add(tile::WALL, wall);
+        return tileTypes;
+    }
+
+    // pairs of a walkable cell, where a unit can stand, and any cell closer than `radius`
+    std::vector<Pair> collectPairs(LevelData const & level, TileTypes const & tileTypes, int radius) {
+        std::vector<Pair> pairs;
+        for (Coord2i from{}; from.y < LEVEL_ROWS; ++from.y) {
+            for (from.x = 0; from.x < LEVEL_COLS; ++from.x) {
+                if (tileTypes.isOpaque(level[from]))
+                    continue;
+                for (Coord2i to{}; to.y < LEVEL_ROWS; ++to.y)
+                    for (to.x = 0; to.x < LEVEL_COLS; ++to.x)
+                        if (distSquared(from, to) < sqr(radius))
+                            pairs.push_back(Pair{ from, to });
+            }
+        }
+        return pairs;
+    }
+
+    template<class Fn>
+    double nanosecondsPerPair(std::vector<Pair> const & pairs, long long & seen, Fn && isVisible) {
+        auto start = std::chrono::steady_clock::now();
+        for (auto const & pair : pairs)
+            seen += isVisible(pair.from, pair.to);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / pairs.size();
+    }
+}
+
+int main(int argc, char ** argv) {
+    if (argc > 3) {
+        std::cerr << "usage: los_check [maps [radius]]\n";
+        return 2;
+    }
+    int maps = argc >= 2 ? std::stoi(argv[1]) : 30;
+    int radius = argc == 3 ? std::stoi(argv[2]) : 24;
+    if (maps <= 0 or radius <= 0) {
+        std::cerr << "los_check: the map count and the radius must be positive\n";
+        return 2;
+    }
+
+    TileTypes const tileTypes = makeTileTypes();
+    auto level = std::make_unique<LevelData>();
+    LevelRandom random(1);
+
+    long long pairCount = 0;
+    long long differences = 0;
+    long long seenByReference = 0;
+    long long seenByLos = 0;
+    long long seenByTable = 0;
+    double referenceTime = 0;
+    double losTime = 0;
+    double tableTime = 0;
+    for (int map = 0; map < maps; ++map) {
+        double walls = 0.05 + 0.05 * (map % 10);
+        level->forEach([&] (Tile & tile) {
+            tile = random.chance(walls) ? tile::WALL : tile::FLOOR;
+        });
+
+        auto pairs = collectPairs(*level, tileTypes, radius);
+        pairCount += pairs.size();
+        for (auto const & pair : pairs) {
+            bool expected = reference::isVisible(*level, tileTypes, pair.from, pair.to);
+            if (los::isVisible(*level, tileTypes, pair.from, pair.to) != expected
+                    or fov::isVisible(*level, tileTypes, pair.from, pair.to) != expected) {
+                if (differences == 0)
+                    std::cerr << "map " << map << ": " << pair.from.x << ":" << pair.from.y << " -> "
+                        << pair.to.x << ":" << pair.to.y << " is " << (expected ? "" : "not ") << "visible before\n";
+                ++differences;
+            }
+        }
+
+        // weighted by the pairs, so the times are per query over all maps
+        double share = double(pairs.size());
+        referenceTime += share * nanosecondsPerPair(pairs, seenByReference, [&] (Coord2i from, Coord2i to) {
+            return reference::isVisible(*level, tileTypes, from, to);
+        });
+        losTime += share * nanosecondsPerPair(pairs, seenByLos, [&] (Coord2i from, Coord2i to) {
+            return los::isVisible(*level, tileTypes, from, to);
+        });
+        tableTime += share * nanosecondsPerPair(pairs, seenByTable, [&] (Coord2i from, Coord2i to) {
+            return fov::isVisible(*level, tileTypes, from, to);
+        });
+    }
+
+    std::cout << maps << " maps, " << pairCount << " pairs closer than " << radius << ", "
+        << differences << " differences\n"
+        << "double:      " << referenceTime / pairCount << " ns a pair, " << seenByReference << " visible\n"
+        << "fixed point: " << losTime / pairCount << " ns a pair, " << seenByLos << " visible\n"
+        << "ray table:   " << tableTime / pairCount << " ns a pair, " << seenByTable << " visible\n";
+    return differences == 0 ? 0 : 1;
+}
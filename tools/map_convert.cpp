@@ -0,0 +1,59 @@
+// Converts a text map (whitespace separated tile ids of data/tiles.yaml, row by row) into
+// the binary level file the game loads:
+//
+//     map_convert map.me map.lvl [cols rows]
+//
+// The size defaults to the level size of the game.
+
+#include<level_file.hpp>
+
+#include<fmt/format.h>
+
+#include<cstdint>
+#include<fstream>
+#include<iostream>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+int main(int argc, char ** argv) {
+    if (argc != 3 and argc != 5) {
+        std::cerr << "usage: map_convert <text map> <level file> [cols rows]\n";
+        return 2;
+    }
+
+    try {
+        int cols = argc == 5 ? std::stoi(argv[3]) : LEVEL_COLS;
+        int rows = argc == 5 ? std::stoi(argv[4]) : LEVEL_ROWS;
+        if (rows <= 0 or cols <= 0)
+            throw std::logic_error("The size must be positive");
+
+        std::ifstream in{ argv[1] };
+        if (not in)
+            throw std::logic_error(fmt::format("Can't open '{}'", argv[1]));
+
+        std::vector<std::uint8_t> tiles;
+        tiles.reserve(std::size_t(rows) * cols);
+        int tile;
+        while (in >> tile) {
+            // the game checks the ids against its tile types when it loads the level
+            if (tile <= 0 or tile >= TileTypes::COUNT)
+                throw std::logic_error(fmt::format("Tile id {} at {}:{} is out of range",
+                            tile, tiles.size() % cols, tiles.size() / cols));
+            tiles.push_back(static_cast<std::uint8_t>(tile));
+        }
+        if (not in.eof())
+            throw std::logic_error(fmt::format("'{}' has something that isn't a tile number", argv[1]));
+        if (tiles.size() != std::size_t(rows) * cols)
+            throw std::logic_error(fmt::format("'{}' has {} tiles, a {}x{} map needs {}",
+                        argv[1], tiles.size(), cols, rows, std::size_t(rows) * cols));
+
+        std::ofstream out{ argv[2], std::ios::binary };
+        writeLevelFile(out, rows, cols, tiles.data(), {});
+        if (not out)
+            throw std::logic_error(fmt::format("Can't write '{}'", argv[2]));
+    } catch (std::exception const & e) {
+        std::cerr << "map_convert: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,45 @@
+// Measures mazes generated per second:
+//
+//     maze_bench [cols rows [levels]]
+//
+// Levels of the game size, 81x21, and 100000 of them by default.
+
+#include<gen_map.hpp>
+#include<level.hpp>
+
+#include<chrono>
+#include<cstdint>
+#include<iostream>
+#include<string>
+#include<vector>
+
+int main(int argc, char ** argv) {
+    if (argc != 1 and argc != 3 and argc != 4) {
+        std::cerr << "usage: maze_bench [cols rows [levels]]\n";
+        return 2;
+    }
+    int cols = argc >= 3 ? std::stoi(argv[1]) : LEVEL_COLS;
+    int rows = argc >= 3 ? std::stoi(argv[2]) : LEVEL_ROWS;
+    int levels = argc == 4 ? std::stoi(argv[3]) : 100000;
+    if (cols <= 0 or rows <= 0 or levels <= 0) {
+        std::cerr << "maze_bench: sizes and the level count must be positive\n";
+        return 2;
+    }
+
+    std::vector<Tile> tiles(std::size_t(rows) * cols);
+    long long floor = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int level = 0; level < levels; ++level) {
+        LevelRandom random(level);
+        gen::generateMaze(tiles.data(), rows, cols, random);
+        // the result is used, so the levels can't be optimized away
+        floor += tiles[cols + 1] == tile::FLOOR;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << cols << "x" << rows << ", " << levels << " levels in " << elapsed.count() << " s: "
+        << levels / elapsed.count() << " levels/s, "
+        << elapsed.count() * 1e6 / levels << " us a level, "
+        << floor << " with the first cell open\n";
+}
@@ -0,0 +1,144 @@
+// Writes a maze of any size into a level file. The maze is generated and written a row at
+// a time, so the memory it takes doesn't grow with the number of rows:
+//
+//     maze_stream [--check] <level file> cols rows [seed]
+//
+// The seed is 0 by default. With --check the file is then opened the way the game opens
+// level files and checked: the border is walls, every maze cell is open and all the floor
+// is connected. The check keeps a bit per tile.
+
+#include<gen_stream.hpp>
+#include<level_file.hpp>
+
+#include<fmt/format.h>
+
+#include<chrono>
+#include<cstdint>
+#include<fstream>
+#include<iostream>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+namespace {
+    // the two tiles the maze generators write, the rest of data/tiles.yaml doesn't matter here
+    TileTypes makeTileTypes() {
+        TileTypes tileTypes;
+        TileType floor;
+        floor.name = "floor";
+        floor.walkable = true;
+        tileTypes.add(tile::FLOOR, floor);
+        TileType wall;
+        wall.name = "wall";
+        wall.opaque = true;
+        tileTypes.add(tile::WALL, wall);
+        return tileTypes;
+    }
+
+    void writeMaze(std::string const & filename, int rows, int cols, std::uint64_t seed) {
+        std::ofstream out{ filename, std::ios::binary };
+        if (not out)
+            throw std::logic_error(fmt::format("Can't open '{}'", filename));
+
+        writeLevelHeader(out, rows, cols);
+        int nextRow = 0;
+        gen::streamMaze(rows, cols, seed, [&] (int row, Tile const * cells) {
+            if (row != nextRow)
+                throw std::logic_error(fmt::format("Row {} came instead of row {}", row, nextRow));
+            out.write(reinterpret_cast<char const *>(cells), cols);
+            ++nextRow;
+        });
+        if (nextRow != rows)
+            throw std::logic_error(fmt::format("The maze has {} rows instead of {}", nextRow, rows));
+        if (not out.flush())
+            throw std::logic_error(fmt::format("Can't write '{}'", filename));
+    }
+
+    void checkMaze(std::string const & filename, int rows, int cols) {
+        TileTypes const tileTypes = makeTileTypes();
+        LevelFile file(filename, tileTypes);
+        if (file.getRows() != rows or file.getCols() != cols)
+            throw std::logic_error(fmt::format("The file is {}x{} instead of {}x{}",
+                        file.getCols(), file.getRows(), cols, rows));
+
+        int const mazeCols = (cols - 1) / 2;
+        int const mazeRows = mazeCols == 0 ? 0 : (rows - 1) / 2;
+        long long floor = 0;
+        std::size_t start = 0;
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                Tile tile = file.tileAt(r, c);
+                bool border = r == 0 or c == 0 or r >= 2 * mazeRows or c >= 2 * mazeCols;
+                bool mazeCell = r % 2 == 1 and c % 2 == 1 and not border;
+                if (border and tile != tile::WALL)
+                    throw std::logic_error(fmt::format("The border is open at {}:{}", c, r));
+                if (mazeCell and tile != tile::FLOOR)
+                    throw std::logic_error(fmt::format("Maze cell {}:{} is a wall", c, r));
+                if (tile == tile::FLOOR and floor++ == 0)
+                    start = std::size_t(r) * cols + c;
+            }
+        }
+        if (floor == 0)
+            return;
+
+        // 4-connected, passages of the maze are straight
+        std::vector<bool> seen(std::size_t(rows) * cols);
+        std::vector<std::size_t> stack{ start };
+        seen[start] = true;
+        long long reached = 0;
+        while (not stack.empty()) {
+            std::size_t index = stack.back();
+            stack.pop_back();
+            ++reached;
+            int r = static_cast<int>(index / cols);
+            int c = static_cast<int>(index % cols);
+            auto visit = [&] (int nr, int nc) {
+                std::size_t next = std::size_t(nr) * cols + nc;
+                if (file.tileAt(nr, nc) == tile::FLOOR and not seen[next]) {
+                    seen[next] = true;
+                    stack.push_back(next);
+                }
+            };
+            // floor never touches the edge of the map, the border is walls
+            visit(r - 1, c);
+            visit(r + 1, c);
+            visit(r, c - 1);
+            visit(r, c + 1);
+        }
+        if (reached != floor)
+            throw std::logic_error(fmt::format("Only {} of {} floor tiles are connected", reached, floor));
+    }
+}
+
+int main(int argc, char ** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    bool check = not args.empty() and args.front() == "--check";
+    if (check)
+        args.erase(args.begin());
+    if (args.size() != 3 and args.size() != 4) {
+        std::cerr << "usage: maze_stream [--check] <level file> cols rows [seed]\n";
+        return 2;
+    }
+
+    try {
+        std::string const & filename = args[0];
+        int cols = std::stoi(args[1]);
+        int rows = std::stoi(args[2]);
+        std::uint64_t seed = args.size() == 4 ? std::stoull(args[3]) : 0;
+        if (rows <= 0 or cols <= 0 or rows > LevelFile::MAX_SIDE or cols > LevelFile::MAX_SIDE)
+            throw std::logic_error(fmt::format("The sides must be 1 to {}", LevelFile::MAX_SIDE));
+
+        auto start = std::chrono::steady_clock::now();
+        writeMaze(filename, rows, cols, seed);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << cols << "x" << rows << " maze written in " << elapsed.count() << " s\n";
+
+        if (check) {
+            checkMaze(filename, rows, cols);
+            std::cout << "checked: walled border, every maze cell open, the floor connected\n";
+        }
+    } catch (std::exception const & e) {
+        std::cerr << "maze_stream: " << e.what() << '\n';
+        return 1;
+    }
+}
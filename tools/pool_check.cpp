@@ -0,0 +1,130 @@
+// Checks that the object pools stop growing when objects are allocated on one thread and
+// freed on another, the way the level factory builds levels for the game thread:
+//
+//     pool_check [rounds [objects]]
+//
+// Every round a worker allocates the objects of a level, mixed sizes, and the main thread
+// frees them. Every tenth round the worker is replaced by a new thread. 1000 rounds of
+// 5000 objects by default. Exits with 1 if the pools still take chunks after the first rounds.
+
+#include<object_pool.hpp>
+
+#include<algorithm>
+#include<condition_variable>
+#include<cstddef>
+#include<iostream>
+#include<memory>
+#include<mutex>
+#include<string>
+#include<thread>
+#include<utility>
+#include<vector>
+
+namespace {
+    struct Object {
+        virtual ~Object() = default;
+
+        static void * operator new(std::size_t size) { return pool::allocate(size); }
+        static void operator delete(void * ptr, std::size_t size) { pool::deallocate(ptr, size); }
+    };
+
+    template<std::size_t Size>
+    struct Sized : Object {
+        char payload[Size];
+    };
+
+    std::unique_ptr<Object> makeObject(int index) {
+        switch (index % 4) {
+            case 0: return std::make_unique<Sized<24>>();
+            case 1: return std::make_unique<Sized<72>>();
+            case 2: return std::make_unique<Sized<200>>();
+            default: return std::make_unique<Sized<600>>();
+        }
+    }
+
+    using Level = std::vector<std::unique_ptr<Object>>;
+
+    Level buildLevel(int count, int round) {
+        Level level;
+        level.reserve(count);
+        for (int i = 0; i < count; ++i)
+            level.push_back(makeObject(i + round));
+        return level;
+    }
+
+    //////////////////////////////////////////////////
+    // Passes levels from the worker to the main thread. The worker builds the next level
+    // only when it is asked for, so at most two levels are alive and the pools are bound
+    // to stop growing after the first rounds, unless the freed blocks aren't reused.
+    class Handoff {
+    public:
+        // on the worker
+        void put(int count, int round) {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [this] { return wanted; });
+            wanted = false;
+            lock.unlock();
+            Level built = buildLevel(count, round);
+            lock.lock();
+            level = std::move(built);
+            ready = true;
+            changed.notify_all();
+        }
+
+        // on the main thread
+        Level take() {
+            std::unique_lock lock(mutex);
+            wanted = true;
+            changed.notify_all();
+            changed.wait(lock, [this] { return ready; });
+            ready = false;
+            return std::move(level);
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool wanted = false;
+        bool ready = false;
+        Level level;
+    };
+}
+
+int main(int argc, char ** argv) {
+    if (argc > 3) {
+        std::cerr << "usage: pool_check [rounds [objects]]\n";
+        return 2;
+    }
+    int rounds = argc >= 2 ? std::stoi(argv[1]) : 1000;
+    int count = argc == 3 ? std::stoi(argv[2]) : 5000;
+    if (rounds < 20 or count <= 0) {
+        std::cerr << "pool_check: there have to be 20 rounds at least and some objects\n";
+        return 2;
+    }
+
+    long long warmChunks = 0;
+    Level previous;
+    for (int first = 0; first < rounds; first += 10) {
+        int last = std::min(first + 10, rounds);
+        // a new thread takes over the pool of the last one
+        Handoff handoff;
+        std::thread worker([&] {
+            for (int round = first; round < last; ++round)
+                handoff.put(count, round);
+        });
+        for (int round = first; round < last; ++round) {
+            // the level before is dropped on the main thread
+            previous = handoff.take();
+            if (round == 9)
+                warmChunks = pool::getStats().chunks;
+        }
+        worker.join();
+    }
+    previous.clear();
+
+    auto stats = pool::getStats();
+    std::cout << rounds << " rounds of " << count << " objects: " << stats.allocations << " allocations, "
+        << stats.reused << " reused, " << stats.remoteFrees << " freed on another thread\n"
+        << stats.pools << " pools, " << warmChunks << " chunks after 10 rounds, " << stats.chunks << " at the end\n";
+    return stats.chunks == warmChunks ? 0 : 1;
+}
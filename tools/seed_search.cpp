@@ -0,0 +1,320 @@
+// Sweeps level seeds on all cores and prints the seeds whose levels match the constraints.
+// Levels are built by the game's LevelFactory, so a seed gives the same level in the game.
+//
+//     seed_search [options]
+//
+//     --from N                first seed, 0 by default
+//     --count N               how many seeds to check, 1000000 by default
+//     --limit N               stop after N matches, the N lowest seeds are printed
+//     --threads N             all cores by default
+//     --depth N               depth of the levels, 1 by default
+//     --luck N                hero luck for the items, 10 by default
+//     --caves                 cave levels instead of mazes
+//     --min-floor F           at least this share of the cells is floor
+//     --connected             all the floor is one region
+//     --min-enemy-distance N  the nearest enemy is at least N steps away from the entrance
+//     --rooms N               exactly N rooms
+//
+// Run it from the game directory, the game data is read from data/. Matches go to stdout,
+// one "seed floor regions enemies enemy_distance rooms" line each (-1 when no enemy can
+// be reached), the totals go to stderr.
+
+#include<game_data.hpp>
+#include<dungeon_level.hpp>
+#include<level_factory.hpp>
+#include<tile_types.hpp>
+#include<units/hero.hpp>
+
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cstdint>
+#include<cstdio>
+#include<iostream>
+#include<mutex>
+#include<stdexcept>
+#include<string>
+#include<thread>
+#include<vector>
+
+namespace {
+    // seeds handed to a thread at once
+    std::uint64_t const BATCH_SIZE = 64;
+
+    struct Options {
+        std::uint64_t from = 0;
+        std::uint64_t count = 1000000;
+        std::uint64_t limit = UINT64_MAX;
+        int threads = 0;
+        int depth = 1;
+        int luck = Hero::MAX_LUCK / 2;
+        bool caves = false;
+
+        double minFloor = 0;
+        bool connected = false;
+        int minEnemyDistance = 0;
+        int rooms = -1;
+    };
+
+    struct LevelStats {
+        double floor = 0;
+        int regions = 0;
+        int enemies = 0;
+        int enemyDistance = -1;
+        int rooms = 0;
+    };
+
+    struct Match {
+        std::uint64_t seed;
+        LevelStats stats;
+    };
+
+    int toIndex(Coord2i cell) {
+        return cell.y * LEVEL_COLS + cell.x;
+    }
+
+    bool isFloor(DungeonLevel const & level, Coord2i cell) {
+        return level.tiles.isIndex(cell) and level.tileTypes.isWalkable(level.tiles[cell]);
+    }
+
+    // 8-connected, the way units walk
+    int countRegions(DungeonLevel const & level, std::vector<int> & stack) {
+        std::vector<bool> seen(LEVEL_ROWS * LEVEL_COLS);
+        int regions = 0;
+        for (int r = 0; r < LEVEL_ROWS; ++r) {
+            for (int c = 0; c < LEVEL_COLS; ++c) {
+                Coord2i start{ c, r };
+                if (seen[toIndex(start)] or not isFloor(level, start))
+                    continue;
+                ++regions;
+                seen[toIndex(start)] = true;
+                stack.assign(1, toIndex(start));
+                while (not stack.empty()) {
+                    Coord2i cell{ stack.back() % LEVEL_COLS, stack.back() / LEVEL_COLS };
+                    stack.pop_back();
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            Coord2i near{ cell.x + dx, cell.y + dy };
+                            if (isFloor(level, near) and not seen[toIndex(near)]) {
+                                seen[toIndex(near)] = true;
+                                stack.push_back(toIndex(near));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return regions;
+    }
+
+    // steps from the entrance to the closest enemy, -1 if none can be reached
+    int nearestEnemyDistance(DungeonLevel const & level, std::vector<int> & queue) {
+        std::vector<int> distance(LEVEL_ROWS * LEVEL_COLS, -1);
+        queue.assign(1, toIndex(level.entrance));
+        distance[toIndex(level.entrance)] = 0;
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            Coord2i cell{ queue[head] % LEVEL_COLS, queue[head] / LEVEL_COLS };
+            if (level.units[cell])
+                return distance[queue[head]];
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    Coord2i near{ cell.x + dx, cell.y + dy };
+                    if (isFloor(level, near) and distance[toIndex(near)] == -1) {
+                        distance[toIndex(near)] = distance[queue[head]] + 1;
+                        queue.push_back(toIndex(near));
+                    }
+                }
+            }
+        }
+        return -1;
+    }
+
+    // A room is an area at least two cells wide both ways: maze corridors never have
+    // a 2x2 block of floor, so rooms are the 4-connected groups of such blocks
+    int countRooms(DungeonLevel const & level, std::vector<int> & stack) {
+        auto isBlock = [&] (Coord2i corner) {
+            return isFloor(level, corner) and isFloor(level, corner + Vec2i{ 1, 0 })
+                and isFloor(level, corner + Vec2i{ 0, 1 }) and isFloor(level, corner + Vec2i{ 1, 1 });
+        };
+
+        std::vector<bool> seen(LEVEL_ROWS * LEVEL_COLS);
+        int rooms = 0;
+        for (int r = 0; r + 1 < LEVEL_ROWS; ++r) {
+            for (int c = 0; c + 1 < LEVEL_COLS; ++c) {
+                Coord2i start{ c, r };
+                if (seen[toIndex(start)] or not isBlock(start))
+                    continue;
+                ++rooms;
+                seen[toIndex(start)] = true;
+                stack.assign(1, toIndex(start));
+                while (not stack.empty()) {
+                    Coord2i cell{ stack.back() % LEVEL_COLS, stack.back() / LEVEL_COLS };
+                    stack.pop_back();
+                    for (Vec2i offset : { Vec2i{ 1, 0 }, Vec2i{ -1, 0 }, Vec2i{ 0, 1 }, Vec2i{ 0, -1 } }) {
+                        Coord2i near = cell + offset;
+                        if (near.x + 1 < LEVEL_COLS and near.y + 1 < LEVEL_ROWS and isFloor(level, near)
+                                and not seen[toIndex(near)] and isBlock(near)) {
+                            seen[toIndex(near)] = true;
+                            stack.push_back(toIndex(near));
+                        }
+                    }
+                }
+            }
+        }
+        return rooms;
+    }
+
+    LevelStats measure(DungeonLevel const & level, std::vector<int> & scratch) {
+        LevelStats stats;
+        int floor = 0;
+        for (int r = 0; r < LEVEL_ROWS; ++r) {
+            for (int c = 0; c < LEVEL_COLS; ++c) {
+                floor += level.tileTypes.isWalkable(level.tiles.at(r, c));
+                stats.enemies += bool(level.units.at(r, c));
+            }
+        }
+        stats.floor = double(floor) / (LEVEL_ROWS * LEVEL_COLS);
+        stats.regions = countRegions(level, scratch);
+        stats.enemyDistance = nearestEnemyDistance(level, scratch);
+        stats.rooms = countRooms(level, scratch);
+        return stats;
+    }
+
+    bool matches(LevelStats const & stats, Options const & options) {
+        if (stats.floor < options.minFloor)
+            return false;
+        if (options.connected and stats.regions != 1)
+            return false;
+        // an enemy that can't be reached is as far as it gets
+        if (options.minEnemyDistance > 0 and stats.enemyDistance != -1
+                and stats.enemyDistance < options.minEnemyDistance)
+            return false;
+        if (options.rooms != -1 and stats.rooms != options.rooms)
+            return false;
+        return true;
+    }
+
+    void printUsage() {
+        std::cerr << "usage: seed_search [--from N] [--count N] [--limit N] [--threads N] [--depth N] [--luck N]\n"
+                     "                   [--caves] [--min-floor F] [--connected] [--min-enemy-distance N] [--rooms N]\n";
+    }
+
+    Options parseOptions(int argc, char ** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&] {
+                if (i + 1 == argc)
+                    throw std::logic_error("'" + arg + "' needs a value");
+                return std::string(argv[++i]);
+            };
+
+            if (arg == "--from") {
+                options.from = std::stoull(value());
+            } else if (arg == "--count") {
+                options.count = std::stoull(value());
+            } else if (arg == "--limit") {
+                options.limit = std::stoull(value());
+            } else if (arg == "--threads") {
+                options.threads = std::stoi(value());
+            } else if (arg == "--depth") {
+                options.depth = std::stoi(value());
+            } else if (arg == "--luck") {
+                options.luck = std::stoi(value());
+            } else if (arg == "--caves") {
+                options.caves = true;
+            } else if (arg == "--min-floor") {
+                options.minFloor = std::stod(value());
+            } else if (arg == "--connected") {
+                options.connected = true;
+            } else if (arg == "--min-enemy-distance") {
+                options.minEnemyDistance = std::stoi(value());
+            } else if (arg == "--rooms") {
+                options.rooms = std::stoi(value());
+            } else {
+                throw std::logic_error("Unknown option '" + arg + "'");
+            }
+        }
+        if (options.threads <= 0)
+            options.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (options.depth < 1)
+            throw std::logic_error("The depth starts from 1");
+        return options;
+    }
+}
+
+int main(int argc, char ** argv) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (std::exception const & e) {
+        std::cerr << "seed_search: " << e.what() << '\n';
+        printUsage();
+        return 2;
+    }
+
+    GameData data;
+    try {
+        data.load();
+    } catch (std::exception const & e) {
+        std::cerr << "seed_search: can't load the game data: " << e.what() << '\n';
+        return 1;
+    }
+    LevelFactory factory(data);
+    factory.setGenerator(options.caves ? LevelGenerator::Caves : LevelGenerator::Maze);
+
+    std::uint64_t const end = options.count > UINT64_MAX - options.from ? UINT64_MAX : options.from + options.count;
+    std::atomic<std::uint64_t> nextBatch{ options.from };
+    std::atomic<std::uint64_t> matchCount{ 0 };
+    std::atomic<std::uint64_t> checked{ 0 };
+    std::mutex matchesMutex;
+    std::vector<Match> found;
+
+    // Batches are handed out in seed order and every batch that was handed out is finished,
+    // so when the limit is reached the lowest matching seeds are all known
+    auto search = [&] {
+        std::vector<int> scratch;
+        std::vector<Match> local;
+        while (matchCount < options.limit) {
+            std::uint64_t first = nextBatch.fetch_add(BATCH_SIZE);
+            if (first >= end)
+                break;
+            std::uint64_t last = first + std::min(BATCH_SIZE, end - first);
+            for (std::uint64_t seed = first; seed < last; ++seed) {
+                auto level = factory.build(options.depth, options.luck, seed);
+                LevelStats stats = measure(*level, scratch);
+                if (matches(stats, options)) {
+                    local.push_back(Match{ seed, stats });
+                    ++matchCount;
+                }
+            }
+            checked += last - first;
+        }
+        std::lock_guard lock(matchesMutex);
+        found.insert(found.end(), local.begin(), local.end());
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.threads; ++i)
+        threads.emplace_back(search);
+    for (auto & thread : threads)
+        thread.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::sort(found.begin(), found.end(), [] (Match const & a, Match const & b) {
+        return a.seed < b.seed;
+    });
+    if (found.size() > options.limit)
+        found.resize(options.limit);
+
+    for (auto const & [seed, stats] : found) {
+        std::printf("%llu %.3f %d %d %d %d\n", static_cast<unsigned long long>(seed),
+                stats.floor, stats.regions, stats.enemies, stats.enemyDistance, stats.rooms);
+    }
+
+    double perSecond = checked / elapsed.count();
+    std::fprintf(stderr, "%llu levels checked in %.2f s on %d threads: %.0f levels/s, %.1f million an hour, %zu matched\n",
+            static_cast<unsigned long long>(checked.load()), elapsed.count(), options.threads,
+            perSecond, perSecond * 3600 / 1e6, found.size());
+}